@@ -19,12 +19,15 @@ src/debug/mulle-objc-gdb.h
 src/debug/mulle-objc-htmldump.h
 src/debug/mulle-objc-html.h
 src/debug/mulle-objc-lldb.h
+src/debug/mulle-objc-profiledump.h
 src/debug/mulle-objc-symbolizer.h
 src/debug/mulle-objc-typeinfodump.h
+src/debug/mulle-objc-uniqueidaudit.h
 )
 
 set( PRIVATE_HEADERS
 src/include-private.h
+src/mulle-objc-probe.h
 src/reflect/_mulle-objc-runtime-include-private.h
 )
 
@@ -32,6 +35,7 @@ set( PUBLIC_HEADERS
 src/include.h
 src/minimal.h
 src/mulle-metaabi.h
+src/mulle-objc-allocstats.h
 src/mulle-objc-atomicpointer.h
 src/mulle-objc-builtin.h
 src/mulle-objc-cache.h
@@ -42,7 +46,9 @@ src/mulle-objc-class.h
 src/mulle-objc-classpair.h
 src/mulle-objc-class-search.h
 src/mulle-objc-class-struct.h
+src/mulle-objc-epoch.h
 src/mulle-objc-fastclasstable.h
+src/mulle-objc-fastclasstable-index.inc
 src/mulle-objc-fastenumeration.h
 src/mulle-objc-fastmethodtable.h
 src/mulle-objc-infraclass.h
@@ -50,8 +56,10 @@ src/mulle-objc-ivar.h
 src/mulle-objc-ivarlist.h
 src/mulle-objc-jit.inc
 src/mulle-objc-kvccache.h
+src/mulle-objc-kvcplan.h
 src/mulle-objc-load.h
 src/mulle-objc-loadinfo.h
+src/mulle-objc-marshalplan.h
 src/mulle-objc-metaclass.h
 src/mulle-objc-method.h
 src/mulle-objc-methodidconstants.h
@@ -59,6 +67,7 @@ src/mulle-objc-methodlist.h
 src/mulle-objc-object-convenience.h
 src/mulle-objc-object.h
 src/mulle-objc-objectheader.h
+src/mulle-objc-profile.h
 src/mulle-objc-property.h
 src/mulle-objc-propertylist.h
 src/mulle-objc-protocol.h
@@ -66,8 +75,11 @@ src/mulle-objc-protocollist.h
 src/mulle-objc-retain-release.h
 src/mulle-objc-runtime.h
 src/mulle-objc-signature.h
+src/mulle-objc-signatureinfo.h
 src/mulle-objc-super.h
 src/mulle-objc-taggedpointer.h
+src/mulle-objc-traceevent.h
+src/mulle-objc-tracering.h
 src/mulle-objc-try-catch-finally.h
 src/mulle-objc-uniqueidarray.h
 src/mulle-objc-uniqueid.h
@@ -12,8 +12,10 @@ src/debug/mulle-objc-gdb.c
 src/debug/mulle-objc-html.c
 src/debug/mulle-objc-htmldump.c
 src/debug/mulle-objc-lldb.c
+src/debug/mulle-objc-profiledump.c
 src/debug/mulle-objc-symbolizer.c
 src/debug/mulle-objc-typeinfodump.c
+src/debug/mulle-objc-uniqueidaudit.c
 )
 
 set( SIGNATURE_SOURCES
@@ -21,30 +23,37 @@ src/mulle-objc-signature/main.c
 )
 
 set( SOURCES
+src/mulle-objc-allocstats.c
 src/mulle-objc-cache.c
 src/mulle-objc-call.c
 src/mulle-objc-callqueue.c
 src/mulle-objc-class.c
 src/mulle-objc-classpair.c
 src/mulle-objc-class-search.c
+src/mulle-objc-epoch.c
 src/mulle-objc-fastenumeration.c
 src/mulle-objc-fastmethodtable.c
 src/mulle-objc-infraclass.c
 src/mulle-objc-ivar.c
 src/mulle-objc-ivarlist.c
 src/mulle-objc-kvccache.c
+src/mulle-objc-kvcplan.c
 src/mulle-objc-load.c
 src/mulle-objc-loadinfo.c
+src/mulle-objc-marshalplan.c
 src/mulle-objc-metaclass.c
 src/mulle-objc-method.c
 src/mulle-objc-methodlist.c
+src/mulle-objc-profile.c
 src/mulle-objc-property.c
 src/mulle-objc-propertylist.c
 src/mulle-objc-protocol.c
 src/mulle-objc-protocollist.c
 src/mulle-objc-retain-release.c
 src/mulle-objc-signature.c
+src/mulle-objc-signatureinfo.c
 src/mulle-objc-super.c
+src/mulle-objc-tracering.c
 src/mulle-objc-try-catch-finally.c
 src/mulle-objc-uniqueidarray.c
 src/mulle-objc-uniqueid.c
@@ -59,6 +68,10 @@ set( STANDALONE_SOURCES
 src/mulle-objc-runtime-standalone.c
 )
 
+set( TRACEDECODE_SOURCES
+src/mulle-objc-tracedecode/main.c
+)
+
 set( UNIQUEID_SOURCES
 src/mulle-objc-uniqueid/main.c
 )
@@ -34,6 +34,7 @@
 //
 #include "mulle-objc-csvdump.h"
 
+#include "mulle-objc-allocstats.h"
 #include "mulle-objc-cache.h"
 #include "mulle-objc-class.h"
 #include "mulle-objc-universe-class.h"
@@ -47,6 +48,7 @@
 #include "mulle-objc-universe.h"
 
 #include <errno.h>
+#include <stdlib.h>
 
 
 static char   *html_escape( char *s)
@@ -332,6 +334,242 @@ void   mulle_objc_universe_csvdump_cachesizes_to_fp( struct _mulle_objc_universe
    mulle_concurrent_hashmapenumerator_done( &rover);
 }
 
+#pragma mark - class lookups
+
+static int  reverse_compare_lookupcount( struct _mulle_objc_infraclass **p_a,
+                                         struct _mulle_objc_infraclass **p_b)
+{
+   uintptr_t   a;
+   uintptr_t   b;
+
+   a = (uintptr_t) _mulle_atomic_pointer_read( &(*p_a)->lookupcount);
+   b = (uintptr_t) _mulle_atomic_pointer_read( &(*p_b)->lookupcount);
+   if( a == b)
+      return( 0);
+   return( a < b ? 1 : -1);
+}
+
+
+//
+// Dumps the classes, that have been looked up through the class cache sorted
+// by count. These are the candidates for the fastclasstable. The last column
+// is the fastclass index, that is already configured (or -1). Needs
+// MULLE_OBJC_COUNT_CLASS_LOOKUP to be set.
+//
+void   mulle_objc_universe_csvdump_classlookups_to_fp( struct _mulle_objc_universe *universe,
+                                                       FILE *fp)
+{
+   struct _mulle_objc_infraclass               **array;
+   struct _mulle_objc_infraclass               **p;
+   struct _mulle_objc_infraclass               **sentinel;
+   struct _mulle_objc_infraclass               *infra;
+   struct mulle_concurrent_hashmapenumerator   rover;
+   unsigned int                                n;
+   uintptr_t                                   count;
+
+   if( ! universe || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   n = mulle_concurrent_hashmap_count( &universe->classtable);
+   if( ! n)
+      return;
+
+   array    = mulle_allocator_calloc( &mulle_stdlib_allocator,
+                                      n,
+                                      sizeof( struct _mulle_objc_infraclass *));
+   sentinel = &array[ n];
+   p        = array;
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->classtable);
+   while( p < sentinel && _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) p))
+      ++p;
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   n = (unsigned int) (p - array);
+   qsort( array,
+          n,
+          sizeof( struct _mulle_objc_infraclass *),
+          (int (*)()) reverse_compare_lookupcount);
+
+   sentinel = &array[ n];
+   for( p = array; p < sentinel; p++)
+   {
+      infra = *p;
+      count = (uintptr_t) _mulle_atomic_pointer_read( &infra->lookupcount);
+      if( ! count)
+         break;
+
+      fprintf( fp, "%08x;%s;%lu;%d\n",
+              _mulle_objc_infraclass_get_classid( infra),
+              _mulle_objc_infraclass_get_name( infra),
+              (unsigned long) count,
+              mulle_objc_get_fastclasstable_index( _mulle_objc_infraclass_get_classid( infra)));
+   }
+
+   mulle_allocator_free( &mulle_stdlib_allocator, array);
+}
+
+
+#pragma mark - cache heat map
+
+//
+// One line per occupied method cache entry. The columns are classid, class
+// name, class type, cache size, slot, home slot of the methodid, probe
+// distance (0 is a direct hit on the inlined check), methodid, method name
+// and hits. Hits are only available with MULLE_OBJC_COUNT_METHOD_CACHE, else
+// the column is empty. Entries with a distance, share their home slot with
+// an entry with a lower distance, they are the collisions.
+//
+void   mulle_objc_class_csvdump_cacheheatmap_to_fp( struct _mulle_objc_class *cls,
+                                                    FILE *fp)
+{
+   struct _mulle_objc_cache        *cache;
+   struct _mulle_objc_cacheentry   *entries;
+   struct _mulle_objc_universe     *universe;
+   mulle_objc_methodid_t           methodid;
+   mulle_objc_cache_uint_t         i;
+   mulle_objc_cache_uint_t         home;
+   int                             distance;
+
+   if( ! cls || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   cache = _mulle_objc_cachepivot_atomicget_cache( &cls->cachepivot.pivot);
+   if( ! _mulle_atomic_pointer_read( &cache->n))
+      return;
+
+   universe = _mulle_objc_class_get_universe( cls);
+   entries  = cache->entries;
+
+   for( i = 0; i < cache->size; i++)
+   {
+      methodid = (mulle_objc_methodid_t) (intptr_t) _mulle_atomic_pointer_read( &entries[ i].key.pointer);
+      if( methodid == MULLE_OBJC_NO_METHODID)
+         continue;
+
+      home     = (methodid & cache->mask) / sizeof( struct _mulle_objc_cacheentry);
+      distance = _mulle_objc_cache_find_entryindex( cache, methodid);
+
+      fprintf( fp, "%08x;%s;%s;%u;%u;%u;%d;%08x;%s;",
+              _mulle_objc_class_get_classid( cls),
+              _mulle_objc_class_get_name( cls),
+              _mulle_objc_class_get_classtypename( cls),
+              (unsigned int) cache->size,
+              (unsigned int) i,
+              (unsigned int) home,
+              distance,
+              methodid,
+              _mulle_objc_universe_describe_methodid( universe, methodid));
+      if( _mulle_objc_cache_is_counting( cache))
+         fprintf( fp, "%lu", (unsigned long) _mulle_objc_cache_get_hits( cache, i));
+      fputc( '\n', fp);
+   }
+}
+
+
+void   mulle_objc_universe_csvdump_cacheheatmap_to_fp( struct _mulle_objc_universe *universe,
+                                                       FILE *fp)
+{
+   intptr_t                                    classid;
+   struct _mulle_objc_infraclass               *infra;
+   struct _mulle_objc_metaclass                *meta;
+   struct mulle_concurrent_hashmapenumerator   rover;
+
+   if( ! universe || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->classtable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, &classid, (void **) &infra))
+   {
+      meta = _mulle_objc_infraclass_get_metaclass( infra);
+
+      mulle_objc_class_csvdump_cacheheatmap_to_fp( _mulle_objc_metaclass_as_class( meta), fp);
+      mulle_objc_class_csvdump_cacheheatmap_to_fp( _mulle_objc_infraclass_as_class( infra), fp);
+   }
+   mulle_concurrent_hashmapenumerator_done( &rover);
+}
+
+
+#pragma mark - instance allocs
+
+struct allocstats_entry
+{
+   struct _mulle_objc_infraclass      *infra;
+   struct mulle_objc_allocstatsinfo   info;
+};
+
+
+static int  reverse_compare_allocstats( struct allocstats_entry *a,
+                                        struct allocstats_entry *b)
+{
+   if( a->info.live != b->info.live)
+      return( a->info.live < b->info.live ? 1 : -1);
+   if( a->info.bytes != b->info.bytes)
+      return( a->info.bytes < b->info.bytes ? 1 : -1);
+   return( 0);
+}
+
+
+//
+// Dumps the instance accounting of all classes, that allocated something,
+// sorted by live instances. The columns are classid, name, live instances,
+// allocations, bytes allocated in total and peak of live instances. Needs
+// MULLE_OBJC_COUNT_INSTANCE_ALLOC to be set.
+//
+void   mulle_objc_universe_csvdump_instanceallocs_to_fp( struct _mulle_objc_universe *universe,
+                                                         FILE *fp)
+{
+   struct allocstats_entry                     *array;
+   struct allocstats_entry                     *p;
+   struct allocstats_entry                     *sentinel;
+   struct _mulle_objc_infraclass               *infra;
+   struct mulle_concurrent_hashmapenumerator   rover;
+   unsigned int                                n;
+
+   if( ! universe || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   n = mulle_concurrent_hashmap_count( &universe->classtable);
+   if( ! n)
+      return;
+
+   array    = mulle_allocator_calloc( &mulle_stdlib_allocator,
+                                      n,
+                                      sizeof( struct allocstats_entry));
+   sentinel = &array[ n];
+   p        = array;
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->classtable);
+   while( p < sentinel && _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &infra))
+   {
+      _mulle_objc_infraclass_get_allocstatsinfo( infra, &p->info);
+      if( ! p->info.allocs)
+         continue;
+      p->infra = infra;
+      ++p;
+   }
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   n = (unsigned int) (p - array);
+   qsort( array,
+          n,
+          sizeof( struct allocstats_entry),
+          (int (*)()) reverse_compare_allocstats);
+
+   sentinel = &array[ n];
+   for( p = array; p < sentinel; p++)
+      fprintf( fp, "%08x;%s;%lu;%lu;%lu;%lu\n",
+              _mulle_objc_infraclass_get_classid( p->infra),
+              _mulle_objc_infraclass_get_name( p->infra),
+              (unsigned long) p->info.live,
+              (unsigned long) p->info.allocs,
+              (unsigned long) p->info.bytes,
+              (unsigned long) p->info.peak);
+
+   mulle_allocator_free( &mulle_stdlib_allocator, array);
+}
+
+
 #pragma mark - dump starters
 
 void
@@ -397,6 +635,69 @@ void
 }
 
 
+void
+  mulle_objc_universe_csvdump_classlookups_to_filename( struct _mulle_objc_universe *universe,
+                                                        char *filename)
+{
+   FILE   *fp;
+
+   fp = fopen( filename, "w");  // append makes no sense
+   if( ! fp)
+   {
+      perror( "fopen:");
+      return;
+   }
+
+   mulle_objc_universe_csvdump_classlookups_to_fp( universe, fp);
+
+   fclose( fp);
+
+   fprintf( stderr, "Dumped class lookups to \"%s\"\n", filename);
+}
+
+
+void
+  mulle_objc_universe_csvdump_instanceallocs_to_filename( struct _mulle_objc_universe *universe,
+                                                          char *filename)
+{
+   FILE   *fp;
+
+   fp = fopen( filename, "w");  // append makes no sense
+   if( ! fp)
+   {
+      perror( "fopen:");
+      return;
+   }
+
+   mulle_objc_universe_csvdump_instanceallocs_to_fp( universe, fp);
+
+   fclose( fp);
+
+   fprintf( stderr, "Dumped instance allocations to \"%s\"\n", filename);
+}
+
+
+void
+  mulle_objc_universe_csvdump_cacheheatmap_to_filename( struct _mulle_objc_universe *universe,
+                                                        char *filename)
+{
+   FILE   *fp;
+
+   fp = fopen( filename, "w");  // append makes no sense
+   if( ! fp)
+   {
+      perror( "fopen:");
+      return;
+   }
+
+   mulle_objc_universe_csvdump_cacheheatmap_to_fp( universe, fp);
+
+   fclose( fp);
+
+   fprintf( stderr, "Dumped method cache heat map to \"%s\"\n", filename);
+}
+
+
 #pragma mark - loadinfo
 
 static void   _fprint_csv_version( FILE *fp, uint32_t version)
@@ -50,6 +50,12 @@ void   mulle_objc_universe_csvdump_cachedmethodcoverage_to_fp( struct _mulle_obj
                                                                FILE *fp);
 void   mulle_objc_universe_csvdump_cachesizes_to_fp( struct _mulle_objc_universe *universe,
                                                      FILE *fp);
+void   mulle_objc_universe_csvdump_classlookups_to_fp( struct _mulle_objc_universe *universe,
+                                                       FILE *fp);
+void   mulle_objc_universe_csvdump_instanceallocs_to_fp( struct _mulle_objc_universe *universe,
+                                                         FILE *fp);
+void   mulle_objc_universe_csvdump_cacheheatmap_to_fp( struct _mulle_objc_universe *universe,
+                                                       FILE *fp);
 
 void   mulle_objc_class_csvdump_methodcoverage_to_fp( struct _mulle_objc_class *cls,
                                                       FILE *fp);
@@ -57,6 +63,8 @@ void   mulle_objc_class_csvdump_cachedmethodcoverage_to_fp( struct _mulle_objc_c
                                                             FILE *fp);
 void   mulle_objc_class_csvdump_cachesizes_to_fp( struct _mulle_objc_class *cls,
                                                   FILE *fp);
+void   mulle_objc_class_csvdump_cacheheatmap_to_fp( struct _mulle_objc_class *cls,
+                                                    FILE *fp);
 
 void   mulle_objc_loadinfo_csvdump_terse_to_fp( struct _mulle_objc_loadinfo *info, FILE *fp);
 
@@ -67,5 +75,11 @@ void   mulle_objc_universe_csvdump_classcoverage_to_filename( struct _mulle_objc
                                                               char *filename);
 void   mulle_objc_universe_csvdump_cachesizes_to_filename( struct _mulle_objc_universe *universe,
                                                            char *filename);
+void   mulle_objc_universe_csvdump_classlookups_to_filename( struct _mulle_objc_universe *universe,
+                                                             char *filename);
+void   mulle_objc_universe_csvdump_instanceallocs_to_filename( struct _mulle_objc_universe *universe,
+                                                               char *filename);
+void   mulle_objc_universe_csvdump_cacheheatmap_to_filename( struct _mulle_objc_universe *universe,
+                                                             char *filename);
 
 #endif
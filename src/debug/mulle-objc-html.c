@@ -815,44 +815,72 @@ char   *mulle_objc_cache_describe_html( struct _mulle_objc_cache *cache,
    unsigned int            i;
    unsigned int            j;
    unsigned int            n;
+   unsigned int            heat;
    int                     index;
    mulle_objc_methodid_t   sel;
+   uintptr_t               hits;
+   uintptr_t               maxhits;
+   char                    hitsbuf[ 32];
 
    n   = cache->size + 3 + 2;
    tmp = mulle_allocator_calloc( &mulle_stdlib_allocator, n, sizeof( char *));
 
    i = 0;
-   asprintf_table_header_colspan( &tmp[ i], styling, 5);
+   asprintf_table_header_colspan( &tmp[ i], styling, 6);
    len = strlen( tmp[ i]);
    ++i;
 
    asprintf( &tmp[ i],
-            "<TR><TD>n</TD><TD COLSPAN=\"4\">%lu</TD></TR>\n",
+            "<TR><TD>n</TD><TD COLSPAN=\"5\">%lu</TD></TR>\n",
             (long) _mulle_atomic_pointer_nonatomic_read( &cache->n));
    len += strlen( tmp[ i]);
    ++i;
    asprintf( &tmp[ i],
-            "<TR><TD>mask</TD><TD COLSPAN=\"4\">0x%lx</TD></TR>\n",
+            "<TR><TD>mask</TD><TD COLSPAN=\"5\">0x%lx</TD></TR>\n",
              (long) cache->mask);
    len += strlen( tmp[ i]);
    ++i;
 
+   // with MULLE_OBJC_COUNT_METHOD_CACHE the hits make the heat, otherwise
+   // the probe distance
+   maxhits = 0;
+   for( j = 0; j < cache->size; j++)
+   {
+      hits = _mulle_objc_cache_get_hits( cache, j);
+      if( hits > maxhits)
+         maxhits = hits;
+   }
 
    for( j = 0; j < cache->size; j++)
    {
-      index = 0;
-      sel   = cache->entries[ j].key.uniqueid;
+      index      = 0;
+      heat       = 0;
+      hitsbuf[0] = 0;
+      sel        = cache->entries[ j].key.uniqueid;
       if( sel)
+      {
          index = _mulle_objc_cache_find_entryindex( cache, sel);
+         if( _mulle_objc_cache_is_counting( cache))
+         {
+            hits = _mulle_objc_cache_get_hits( cache, j);
+            sprintf( hitsbuf, "%lu", (unsigned long) hits);
+            heat = maxhits ? (unsigned int) (hits * 50 / maxhits) : 0;
+         }
+         else
+            heat = index >= 5 ? 50 : index * 10;
+      }
 
       asprintf( &tmp[ i],
-               "<TR><TD>#%ld</TD><TD>%08x</TD><TD>%s</TD><TD>%p</TD><TD>%d (%x)</TD></TR>\n",
+               "<TR STYLE=\"background-color: hsl(0,100%%,%u%%)\">"
+               "<TD>#%ld</TD><TD>%08x</TD><TD>%s</TD><TD>%p</TD><TD>%d (%x)</TD><TD>%s</TD></TR>\n",
+               100 - heat,
                j,
                sel,
                _mulle_objc_universe_describe_methodid( universe, sel),
                cache->entries[ j].value.functionpointer,
                index,
-               sel & cache->mask);
+               sel & cache->mask,
+               hitsbuf);
 
       len += strlen( tmp[ i]);
       ++i;
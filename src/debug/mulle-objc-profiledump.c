@@ -0,0 +1,161 @@
+//
+//  mulle_objc_profiledump.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-profiledump.h"
+
+#include "mulle-objc-class.h"
+#include "mulle-objc-method.h"
+#include "mulle-objc-profile.h"
+#include "mulle-objc-symbolizer.h"
+#include "mulle-objc-universe.h"
+
+#include <errno.h>
+#include <string.h>
+
+
+//
+// how far a return address may be away from the start of a method, to
+// still be attributed to it
+//
+#define MAX_CALLER_OFFSET   0x10000
+
+
+static void   print_caller( struct mulle_objc_symbolizer *symbolizer,
+                            void *caller,
+                            FILE *fp)
+{
+   auto char   buf[ 256];
+   char        *s;
+
+   if( mulle_objc_symbolizer_snprint( symbolizer, caller, MAX_CALLER_OFFSET, buf, sizeof( buf)) <= 0)
+   {
+      fprintf( fp, "%p", caller);
+      return;
+   }
+
+   s = strstr( buf, "]+0x");
+   if( s)
+      s[ 1] = 0;
+   fputs( buf, fp);
+}
+
+
+static void   print_callee( struct mulle_objc_symbolizer *symbolizer,
+                            struct _mulle_objc_universe *universe,
+                            struct _mulle_objc_profilesample *p,
+                            FILE *fp)
+{
+   auto char                       buf[ 256];
+   struct _mulle_objc_descriptor   *desc;
+
+   if( mulle_objc_symbolizer_snprint( symbolizer, (void *) p->imp, 0, buf, sizeof( buf)) > 0)
+   {
+      fputs( buf, fp);
+      return;
+   }
+
+   // forwarded or not in a methodlist
+   desc = _mulle_objc_universe_lookup_descriptor( universe, p->methodid);
+   fprintf( fp, "%c[%s ",
+                _mulle_objc_class_is_metaclass( p->cls) ? '+' : '-',
+                _mulle_objc_class_get_name( p->cls));
+   if( desc)
+      fprintf( fp, "%s]", _mulle_objc_descriptor_get_name( desc));
+   else
+      fprintf( fp, "#%08x]", p->methodid);
+}
+
+
+void   mulle_objc_universe_profiledump_to_fp( struct _mulle_objc_universe *universe,
+                                              FILE *fp)
+{
+   struct mulle_objc_symbolizer       *symbolizer;
+   struct _mulle_objc_profilebuffer   *buffer;
+   struct _mulle_objc_profilesample   *p;
+   struct _mulle_objc_profilesample   *sentinel;
+   uintptr_t                          dropped;
+
+   if( ! universe || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   symbolizer = _mulle_objc_symbolizer_create( universe);
+   dropped    = 0;
+
+   buffer = _mulle_objc_universe_get_profilebuffers( universe);
+   for( ; buffer; buffer = buffer->next)
+   {
+      dropped += buffer->dropped;
+
+      p        = buffer->samples;
+      sentinel = &p[ MULLE_OBJC_PROFILEBUFFER_SIZE];
+      for( ; p < sentinel; p++)
+      {
+         if( ! p->count)
+            continue;
+
+         print_caller( symbolizer, p->caller, fp);
+         fputc( ';', fp);
+         print_callee( symbolizer, universe, p, fp);
+         fprintf( fp, " %lu\n", (unsigned long) p->count);
+      }
+   }
+
+   mulle_objc_symbolizer_destroy( symbolizer);
+
+   if( dropped)
+      fprintf( stderr, "mulle_objc_universe %p warning: %lu profile samples "
+                       "were dropped, because the buffers were full\n",
+                       universe, (unsigned long) dropped);
+}
+
+
+void   mulle_objc_universe_profiledump_to_filename( struct _mulle_objc_universe *universe,
+                                                    char *filename)
+{
+   FILE   *fp;
+
+   fp = fopen( filename, "a");
+   if( ! fp)
+   {
+      perror( "fopen:");
+      return;
+   }
+
+   mulle_objc_universe_profiledump_to_fp( universe, fp);
+
+   fclose( fp);
+
+   fprintf( stderr, "Dumped method call profile to \"%s\"\n", filename);
+}
@@ -0,0 +1,61 @@
+//
+//  mulle_objc_profiledump.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_profiledump_h__
+#define mulle_objc_profiledump_h__
+
+#include <stdio.h>
+
+struct _mulle_objc_universe;
+
+
+//
+// Writes the samples of MULLE_OBJC_PROFILE_METHOD_CALL in the "collapsed
+// stack" format, one line per caller and callee with the number of samples:
+//
+//    -[Foo bar];-[Baz( Category) quux:] 17
+//
+// The offset into the calling method is dropped, so all calls from one
+// method add up. Callers that aren't inside a known method are written as
+// addresses. Feed the output to flamegraph.pl or speedscope.
+//
+void   mulle_objc_universe_profiledump_to_fp( struct _mulle_objc_universe *universe,
+                                              FILE *fp);
+
+// appends to existing files
+void   mulle_objc_universe_profiledump_to_filename( struct _mulle_objc_universe *universe,
+                                                    char *filename);
+
+#endif
@@ -0,0 +1,213 @@
+//
+//  mulle_objc_uniqueidaudit.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-uniqueidaudit.h"
+
+#include "mulle-objc-infraclass.h"
+#include "mulle-objc-load.h"
+#include "mulle-objc-method.h"
+#include "mulle-objc-protocol.h"
+#include "mulle-objc-uniqueid.h"
+#include "mulle-objc-universe.h"
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+struct audit_entry
+{
+   mulle_objc_uniqueid_t   uniqueid;
+   char                    *name;
+   char                    *kind;
+};
+
+
+struct audit_array
+{
+   struct audit_entry   *_values;
+   size_t               _count;
+   size_t               _size;
+};
+
+
+static void   audit_array_add( struct audit_array *array,
+                               mulle_objc_uniqueid_t uniqueid,
+                               char *name,
+                               char *kind)
+{
+   struct audit_entry   *p;
+
+   if( ! name)
+      return;
+
+   if( array->_count == array->_size)
+   {
+      array->_size   = array->_size ? array->_size * 2 : 256;
+      array->_values = mulle_allocator_realloc( &mulle_stdlib_allocator,
+                                                array->_values,
+                                                sizeof( struct audit_entry) * array->_size);
+   }
+
+   p           = &array->_values[ array->_count++];
+   p->uniqueid = uniqueid;
+   p->name     = name;
+   p->kind     = kind;
+}
+
+
+static int   audit_entry_compare( struct audit_entry *a,
+                                  struct audit_entry *b)
+{
+   if( a->uniqueid != b->uniqueid)
+      return( a->uniqueid < b->uniqueid ? -1 : 1);
+   return( strcmp( a->name, b->name));
+}
+
+
+static void   audit_array_add_hashnames( struct audit_array *array,
+                                         struct _mulle_objc_universe *universe)
+{
+   struct mulle_concurrent_pointerarrayenumerator   rover;
+   struct _mulle_objc_loadhashedstringlist          *map;
+   struct _mulle_objc_loadhashedstring              *p;
+   struct _mulle_objc_loadhashedstring              *sentinel;
+
+   rover = mulle_concurrent_pointerarray_enumerate( &universe->hashnames);
+   while( (map = _mulle_concurrent_pointerarrayenumerator_next( &rover)))
+   {
+      p        = map->loadentries;
+      sentinel = &p[ map->n_loadentries];
+      for( ; p < sentinel; p++)
+         audit_array_add( array, p->uniqueid, p->string, "hashname");
+   }
+   mulle_concurrent_pointerarrayenumerator_done( &rover);
+}
+
+
+static void   audit_array_add_tables( struct audit_array *array,
+                                      struct _mulle_objc_universe *universe)
+{
+   struct mulle_concurrent_hashmapenumerator   rover;
+   struct _mulle_objc_infraclass               *infra;
+   struct _mulle_objc_descriptor               *desc;
+   struct _mulle_objc_protocol                 *protocol;
+   intptr_t                                    key;
+   char                                        *name;
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->classtable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &infra))
+      audit_array_add( array,
+                       _mulle_objc_infraclass_get_classid( infra),
+                       _mulle_objc_infraclass_get_name( infra),
+                       "class");
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->descriptortable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &desc))
+      audit_array_add( array,
+                       _mulle_objc_descriptor_get_methodid( desc),
+                       _mulle_objc_descriptor_get_name( desc),
+                       "method");
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->protocoltable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &protocol))
+      audit_array_add( array,
+                       _mulle_objc_protocol_get_protocolid( protocol),
+                       _mulle_objc_protocol_get_name( protocol),
+                       "protocol");
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->categorytable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, &key, (void **) &name))
+      audit_array_add( array, (mulle_objc_uniqueid_t) key, name, "category");
+   mulle_concurrent_hashmapenumerator_done( &rover);
+}
+
+
+unsigned int   mulle_objc_universe_audit_uniqueids_to_fp( struct _mulle_objc_universe *universe,
+                                                          FILE *fp)
+{
+   struct audit_array      array;
+   struct audit_entry      *p;
+   struct audit_entry      *prev;
+   struct audit_entry      *sentinel;
+   mulle_objc_uniqueid_t   expect;
+   unsigned int            problems;
+
+   if( ! universe || ! fp)
+      mulle_objc_universe_fail_code( NULL, EINVAL);
+
+   memset( &array, 0, sizeof( array));
+
+   audit_array_add_hashnames( &array, universe);
+   audit_array_add_tables( &array, universe);
+
+   qsort( array._values,
+          array._count,
+          sizeof( struct audit_entry),
+          (int (*)( const void *, const void *)) audit_entry_compare);
+
+   problems = 0;
+   prev     = NULL;
+   p        = array._values;
+   sentinel = &p[ array._count];
+   for( ; p < sentinel; prev = p, p++)
+   {
+      // superids are chained over the classid, they don't hash plainly
+      if( ! strchr( p->name, ';'))
+      {
+         expect = mulle_objc_uniqueid_from_string( p->name);
+         if( expect != p->uniqueid)
+         {
+            fprintf( fp, "mismatch;%08x;%s;%s;%08x\n",
+                     p->uniqueid, p->kind, p->name, expect);
+            ++problems;
+         }
+      }
+
+      if( prev && prev->uniqueid == p->uniqueid && strcmp( prev->name, p->name))
+      {
+         fprintf( fp, "collision;%08x;%s;%s;%s;%s\n",
+                  p->uniqueid, prev->kind, prev->name, p->kind, p->name);
+         ++problems;
+      }
+   }
+
+   mulle_allocator_free( &mulle_stdlib_allocator, array._values);
+
+   return( problems);
+}
@@ -0,0 +1,229 @@
+//
+//  mulle-objc-allocstats.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+#include "mulle-objc-allocstats.h"
+
+#include "mulle-objc-infraclass.h"
+#include "mulle-objc-universe.h"
+
+#include "include-private.h"
+
+#include <errno.h>
+#include <string.h>
+
+
+static struct _mulle_objc_allocstats   *
+   _mulle_objc_infraclass_get_allocstats( struct _mulle_objc_infraclass *infra)
+{
+   return( _mulle_atomic_pointer_read( &infra->allocstats));
+}
+
+
+static struct _mulle_objc_allocstats   *
+   _mulle_objc_infraclass_create_allocstats( struct _mulle_objc_infraclass *infra)
+{
+   struct _mulle_objc_allocstats   *stats;
+   struct _mulle_objc_universe     *universe;
+   struct mulle_allocator          *allocator;
+
+   universe  = _mulle_objc_infraclass_get_universe( infra);
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   stats     = mulle_allocator_calloc( allocator, 1, sizeof( *stats));
+
+   if( _mulle_atomic_pointer_cas( &infra->allocstats, stats, NULL))
+      return( stats);
+
+   // someone else was faster
+   mulle_allocator_free( allocator, stats);
+   return( _mulle_objc_infraclass_get_allocstats( infra));
+}
+
+
+static unsigned int   _mulle_objc_allocstats_get_shardindex( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_threadinfo   *config;
+
+   // threadinfo maybe already gone, if called in tss destructor
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( ! config)
+      return( 0);
+   return( (unsigned int) _mulle_objc_threadinfo_get_nr( config) & (MULLE_OBJC_ALLOCSTATS_SHARDS - 1));
+}
+
+
+static uintptr_t   _mulle_objc_allocstats_sum( struct _mulle_objc_allocstats *stats,
+                                               struct mulle_objc_allocstatsinfo *info)
+{
+   struct _mulle_objc_allocstatsshard   *p;
+   struct _mulle_objc_allocstatsshard   *sentinel;
+
+   memset( info, 0, sizeof( *info));
+
+   p        = &stats->shards[ 0];
+   sentinel = &p[ MULLE_OBJC_ALLOCSTATS_SHARDS];
+   for( ; p < sentinel; p++)
+   {
+      info->allocs += (uintptr_t) _mulle_atomic_pointer_read( &p->allocs);
+      info->frees  += (uintptr_t) _mulle_atomic_pointer_read( &p->frees);
+      info->bytes  += (uintptr_t) _mulle_atomic_pointer_read( &p->bytes);
+   }
+
+   info->live = info->allocs > info->frees ? info->allocs - info->frees : 0;
+   return( info->live);
+}
+
+
+static uintptr_t   _mulle_objc_allocstats_update_peak( struct _mulle_objc_allocstats *stats,
+                                                       uintptr_t live)
+{
+   uintptr_t   peak;
+
+   for(;;)
+   {
+      peak = (uintptr_t) _mulle_atomic_pointer_read( &stats->peak);
+      if( live <= peak)
+         return( peak);
+      if( _mulle_atomic_pointer_cas( &stats->peak, (void *) live, (void *) peak))
+         return( live);
+   }
+}
+
+
+void   _mulle_objc_infraclass_count_alloc( struct _mulle_objc_infraclass *infra,
+                                           size_t size)
+{
+   struct _mulle_objc_allocstats        *stats;
+   struct _mulle_objc_allocstatsshard   *shard;
+   struct _mulle_objc_universe          *universe;
+   struct mulle_objc_allocstatsinfo     info;
+   uintptr_t                            n;
+
+   stats = _mulle_objc_infraclass_get_allocstats( infra);
+   if( ! stats)
+      stats = _mulle_objc_infraclass_create_allocstats( infra);
+
+   universe = _mulle_objc_infraclass_get_universe( infra);
+   shard    = &stats->shards[ _mulle_objc_allocstats_get_shardindex( universe)];
+
+   _mulle_atomic_pointer_increment( &shard->allocs);
+   _mulle_atomic_pointer_add( &shard->bytes, (intptr_t) size);
+
+   n = (uintptr_t) _mulle_atomic_pointer_read( &shard->allocs);
+   if( ! (n & (MULLE_OBJC_ALLOCSTATS_PEAK_INTERVAL - 1)))
+      _mulle_objc_allocstats_update_peak( stats, _mulle_objc_allocstats_sum( stats, &info));
+}
+
+
+void   _mulle_objc_infraclass_count_free( struct _mulle_objc_infraclass *infra)
+{
+   struct _mulle_objc_allocstats        *stats;
+   struct _mulle_objc_allocstatsshard   *shard;
+   struct _mulle_objc_universe          *universe;
+
+   // allocated before accounting was turned on, live is clamped anyway
+   stats = _mulle_objc_infraclass_get_allocstats( infra);
+   if( ! stats)
+      return;
+
+   universe = _mulle_objc_infraclass_get_universe( infra);
+   shard    = &stats->shards[ _mulle_objc_allocstats_get_shardindex( universe)];
+
+   _mulle_atomic_pointer_increment( &shard->frees);
+}
+
+
+void   _mulle_objc_infraclass_get_allocstatsinfo( struct _mulle_objc_infraclass *infra,
+                                                  struct mulle_objc_allocstatsinfo *info)
+{
+   struct _mulle_objc_allocstats   *stats;
+
+   stats = _mulle_objc_infraclass_get_allocstats( infra);
+   if( ! stats)
+   {
+      memset( info, 0, sizeof( *info));
+      return;
+   }
+
+   info->peak = _mulle_objc_allocstats_update_peak( stats,
+                                                    _mulle_objc_allocstats_sum( stats, info));
+}
+
+
+int   mulle_objc_infraclass_get_allocstatsinfo( struct _mulle_objc_infraclass *infra,
+                                                struct mulle_objc_allocstatsinfo *info)
+{
+   if( ! infra || ! info)
+   {
+      errno = EINVAL;
+      return( -1);
+   }
+
+   _mulle_objc_infraclass_get_allocstatsinfo( infra, info);
+   return( 0);
+}
+
+
+void   _mulle_objc_infraclass_free_allocstats( struct _mulle_objc_infraclass *infra)
+{
+   struct _mulle_objc_allocstats   *stats;
+   struct _mulle_objc_universe     *universe;
+   struct mulle_allocator          *allocator;
+
+   stats = _mulle_atomic_pointer_nonatomic_read( &infra->allocstats);
+   if( ! stats)
+      return;
+
+   universe  = _mulle_objc_infraclass_get_universe( infra);
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   mulle_allocator_free( allocator, stats);
+   _mulle_atomic_pointer_nonatomic_write( &infra->allocstats, NULL);
+}
+
+
+void   _mulle_objc_universe_set_count_instance_alloc( struct _mulle_objc_universe *universe,
+                                                      int flag)
+{
+   _mulle_atomic_pointer_write( &universe->debug.count.instance_alloc,
+                                (void *) (intptr_t) (flag ? 1 : 0));
+}
+
+
+void   mulle_objc_universe_set_count_instance_alloc( struct _mulle_objc_universe *universe,
+                                                     int flag)
+{
+   if( ! universe)
+      return;
+
+   _mulle_objc_universe_set_count_instance_alloc( universe, flag);
+}
@@ -0,0 +1,131 @@
+//
+//  mulle-objc-allocstats.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+#ifndef mulle_objc_allocstats_h__
+#define mulle_objc_allocstats_h__
+
+#include "mulle-objc-atomicpointer.h"
+
+#include "include.h"
+
+
+struct _mulle_objc_infraclass;
+struct _mulle_objc_universe;
+
+//
+// Per class instance accounting, enabled with MULLE_OBJC_COUNT_INSTANCE_ALLOC
+// or at runtime with mulle_objc_universe_set_count_instance_alloc. The
+// checks in the inline alloc and free functions are only compiled in, if
+// MULLE_OBJC_ALLOCSTATS is defined (cmake option MULLE_OBJC_ALLOCSTATS),
+// which is also possible for release builds. Code that allocates or frees
+// instances must be compiled with it too. Then the cost, when accounting is
+// off, is an isa load and one atomic read per alloc and free.
+//
+// The counters of each infraclass are sharded by the thread number, so that
+// threads allocating the same class don't fight over one cache line. Live
+// instances are computed as allocs - frees. If accounting is enabled late,
+// instances that were allocated before are not counted, but may be freed,
+// so live is clamped to 0. The peak is sampled every
+// MULLE_OBJC_ALLOCSTATS_PEAK_INTERVAL allocations of a shard and whenever
+// the stats are read, so it can be a little low.
+//
+#ifndef MULLE_OBJC_ALLOCSTATS_SHARDS
+# define MULLE_OBJC_ALLOCSTATS_SHARDS         16    // power of 2
+#endif
+
+#ifndef MULLE_OBJC_ALLOCSTATS_PEAK_INTERVAL
+# define MULLE_OBJC_ALLOCSTATS_PEAK_INTERVAL  64    // power of 2
+#endif
+
+
+struct _mulle_objc_allocstatsshard
+{
+   mulle_atomic_pointer_t   allocs;
+   mulle_atomic_pointer_t   frees;
+   mulle_atomic_pointer_t   bytes;
+   // keep shards on separate cache lines
+   char                     _pad[ 64 - 3 * sizeof( mulle_atomic_pointer_t)];
+};
+
+
+struct _mulle_objc_allocstats
+{
+   struct _mulle_objc_allocstatsshard   shards[ MULLE_OBJC_ALLOCSTATS_SHARDS];
+   mulle_atomic_pointer_t               peak;
+};
+
+
+// a snapshot, summed over all shards
+struct mulle_objc_allocstatsinfo
+{
+   uintptr_t   live;
+   uintptr_t   allocs;
+   uintptr_t   frees;
+   uintptr_t   bytes;    // total bytes allocated, not live bytes
+   uintptr_t   peak;
+};
+
+
+// called by the inline alloc and free functions, if accounting is enabled
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_infraclass_count_alloc( struct _mulle_objc_infraclass *infra,
+                                           size_t size);
+
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_infraclass_count_free( struct _mulle_objc_infraclass *infra);
+
+
+// fills info with zeroes, if nothing has been counted yet
+MULLE_C_NONNULL_FIRST_SECOND
+void   _mulle_objc_infraclass_get_allocstatsinfo( struct _mulle_objc_infraclass *infra,
+                                                  struct mulle_objc_allocstatsinfo *info);
+
+// returns -1 and sets errno to EINVAL, if a parameter is NULL
+int    mulle_objc_infraclass_get_allocstatsinfo( struct _mulle_objc_infraclass *infra,
+                                                 struct mulle_objc_allocstatsinfo *info);
+
+// frees the counters, used when the infraclass is freed
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_infraclass_free_allocstats( struct _mulle_objc_infraclass *infra);
+
+
+// counting continues with the old values, if it is turned on again
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_universe_set_count_instance_alloc( struct _mulle_objc_universe *universe,
+                                                      int flag);
+
+void   mulle_objc_universe_set_count_instance_alloc( struct _mulle_objc_universe *universe,
+                                                     int flag);
+
+#endif
@@ -35,6 +35,8 @@
 //
 #include "mulle-objc-cache.h"
 
+#include "mulle-objc-epoch.h"
+
 #include "include-private.h"
 #include <assert.h>
 #include <string.h>
@@ -46,10 +48,13 @@
 //
 // cache malloc/frees should not disturb errno, so we preserve it
 //
-struct _mulle_objc_cache   *mulle_objc_cache_new( mulle_objc_cache_uint_t size,
-                                                  struct mulle_allocator *allocator)
+static struct _mulle_objc_cache   *_mulle_objc_cache_new( mulle_objc_cache_uint_t size,
+                                                         int counting,
+                                                         struct mulle_allocator *allocator)
 {
    struct _mulle_objc_cache  *cache;
+   size_t                    bytes;
+   size_t                    hits_offset;
    int                       preserve;
 
    assert( allocator);
@@ -60,18 +65,37 @@ struct _mulle_objc_cache   *mulle_objc_cache_new( mulle_objc_cache_uint_t size,
 
    assert( ! (size & (size - 1)));          // check for tumeni bits
 
+   hits_offset = mulle_objc_cache_sizeof( size, 0);
+   bytes       = mulle_objc_cache_sizeof( size, counting);
+
    preserve = errno;
-   cache    = _mulle_allocator_calloc( allocator, 1, sizeof( struct _mulle_objc_cache) + sizeof( struct _mulle_objc_cacheentry) * (size - 1));
+   cache    = _mulle_allocator_calloc( allocator, 1, bytes);
    errno    = preserve;
 
    cache->size = size;
    // myhardworkbythesewordsguardedpleasedontsteal © Nat!
    cache->mask = (size - 1) * sizeof( struct _mulle_objc_cacheentry);    // preshift
+   if( counting)
+      cache->hits = (mulle_atomic_pointer_t *) &((char *) cache)[ hits_offset];
 
    return( cache);
 }
 
 
+struct _mulle_objc_cache   *mulle_objc_cache_new( mulle_objc_cache_uint_t size,
+                                                  struct mulle_allocator *allocator)
+{
+   return( _mulle_objc_cache_new( size, 0, allocator));
+}
+
+
+struct _mulle_objc_cache   *mulle_objc_cache_new_counting( mulle_objc_cache_uint_t size,
+                                                           struct mulle_allocator *allocator)
+{
+   return( _mulle_objc_cache_new( size, 1, allocator));
+}
+
+
 void   _mulle_objc_cache_free( struct _mulle_objc_cache *cache,
                                struct mulle_allocator *allocator)
 {
@@ -93,6 +117,10 @@ void   _mulle_objc_cache_abafree( struct _mulle_objc_cache *cache,
    assert( allocator);
 
    preserve = errno;
+   // abafree has no size, tell the epoch gc for its pending bytes metric
+   if( allocator->abafree == _mulle_objc_epochgc_abafree)
+      _mulle_objc_epochgc_set_sizehint( allocator->aba,
+                                        _mulle_objc_cache_get_allocationsize( cache));
    _mulle_allocator_abafree( allocator, cache);
    errno    = preserve;
 }
@@ -354,13 +382,15 @@ struct _mulle_objc_cacheentry   *
 
 
 struct _mulle_objc_cacheentry   *
-   _mulle_objc_cache_add_pointer_entry( struct _mulle_objc_cache *cache,
-                                        void *pointer,
-                                        mulle_objc_uniqueid_t uniqueid)
+   __mulle_objc_cache_add_pointer_entry( struct _mulle_objc_cache *cache,
+                                         void *pointer,
+                                         mulle_objc_uniqueid_t uniqueid,
+                                         int *p_added)
 {
    struct _mulle_objc_cacheentry   *entry;
    mulle_objc_uniqueid_t           offset;
 
+   assert( p_added);
    assert( cache);
    assert( pointer);
    assert( mulle_objc_uniqueid_is_sane( uniqueid));
@@ -384,6 +414,7 @@ struct _mulle_objc_cacheentry   *
       // implementation set by someone else...
       // if that guy is done writing the uniqueid and it's ours, then fine!
       // #1#
+      *p_added = 0;
       if( _mulle_atomic_pointer_read( &entry->key.pointer) == (void *) (uintptr_t) uniqueid)
          return( entry);
 
@@ -396,10 +427,22 @@ struct _mulle_objc_cacheentry   *
    assert( ! entry->key.uniqueid);
    _mulle_atomic_pointer_write( &entry->key.pointer, (void *) (uintptr_t) uniqueid);
 
+   *p_added = 1;
    return( entry);
 }
 
 
+struct _mulle_objc_cacheentry   *
+   _mulle_objc_cache_add_pointer_entry( struct _mulle_objc_cache *cache,
+                                        void *pointer,
+                                        mulle_objc_uniqueid_t uniqueid)
+{
+   int   added;
+
+   return( __mulle_objc_cache_add_pointer_entry( cache, pointer, uniqueid, &added));
+}
+
+
 struct _mulle_objc_cacheentry   *
    _mulle_objc_cache_add_functionpointer_entry( struct _mulle_objc_cache *cache,
                                                 mulle_functionpointer_t pointer,
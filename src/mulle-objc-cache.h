@@ -67,8 +67,18 @@ struct _mulle_objc_cacheentry
 };
 
 
+//
+// misses and probes are statistics for the adaptive cache policy. They are
+// placed in front, so that the offsets of n, size and mask relative to the
+// entries (which is what the inlined lookups use) stay the same. For the
+// same reason hits is in front. It points to a counter per entry behind the
+// entries, if the cache was created with mulle_objc_cache_new_counting.
+//
 struct _mulle_objc_cache
 {
+   mulle_atomic_pointer_t          *hits;   // NULL, if not counting
+   mulle_atomic_pointer_t          misses;  // number of slow path adds
+   mulle_atomic_pointer_t          probes;  // sum of probe lengths on insert
    mulle_atomic_pointer_t          n;
    mulle_objc_cache_uint_t         size;  // don't optimize away (alignment!)
    mulle_objc_cache_uint_t         mask;
@@ -103,6 +113,24 @@ static inline size_t   _mulle_objc_cache_get_resize( struct _mulle_objc_cache *c
 }
 
 
+static inline size_t   mulle_objc_cache_sizeof( mulle_objc_cache_uint_t size,
+                                                int counting)
+{
+   size_t   bytes;
+
+   bytes = sizeof( struct _mulle_objc_cache) + sizeof( struct _mulle_objc_cacheentry) * (size - 1);
+   if( counting)
+      bytes += sizeof( mulle_atomic_pointer_t) * size;
+   return( bytes);
+}
+
+
+static inline size_t   _mulle_objc_cache_get_allocationsize( struct _mulle_objc_cache *cache)
+{
+   return( mulle_objc_cache_sizeof( cache->size, cache->hits != NULL));
+}
+
+
 MULLE_C_ALWAYS_INLINE static inline struct _mulle_objc_cache  *
     _mulle_objc_cacheentry_get_cache_from_entries( struct _mulle_objc_cacheentry *entries)
 {
@@ -190,6 +218,40 @@ static inline mulle_objc_cache_uint_t
 }
 
 
+static inline mulle_objc_cache_uint_t
+    _mulle_objc_cache_get_probes( struct _mulle_objc_cache *cache)
+{
+   return( (mulle_objc_cache_uint_t) (uintptr_t) _mulle_atomic_pointer_read( &cache->probes));
+}
+
+
+// returns 0 also, if the cache isn't counting hits
+static inline uintptr_t
+    _mulle_objc_cache_get_hits( struct _mulle_objc_cache *cache,
+                                mulle_objc_cache_uint_t index)
+{
+   if( ! cache->hits)
+      return( 0);
+   return( (uintptr_t) _mulle_atomic_pointer_read( &cache->hits[ index]));
+}
+
+
+static inline int
+    _mulle_objc_cache_is_counting( struct _mulle_objc_cache *cache)
+{
+   return( cache->hits != NULL);
+}
+
+
+static inline void
+    _mulle_objc_cache_count_hit( struct _mulle_objc_cache *cache,
+                                 struct _mulle_objc_cacheentry *entry)
+{
+   if( cache->hits)
+      _mulle_atomic_pointer_increment( &cache->hits[ entry - cache->entries]);
+}
+
+
 static inline mulle_objc_uniqueid_t
     _mulle_objc_cache_get_size( struct _mulle_objc_cache *cache)
 {
@@ -209,6 +271,10 @@ static inline mulle_objc_cache_uint_t
 struct _mulle_objc_cache   *mulle_objc_cache_new( mulle_objc_cache_uint_t size,
                                                   struct mulle_allocator *allocator);
 
+// with a hit counter per entry (MULLE_OBJC_COUNT_METHOD_CACHE)
+struct _mulle_objc_cache   *mulle_objc_cache_new_counting( mulle_objc_cache_uint_t size,
+                                                           struct mulle_allocator *allocator);
+
 void   _mulle_objc_cache_free( struct _mulle_objc_cache *cache,
                                struct mulle_allocator *allocator);
 void   _mulle_objc_cache_abafree( struct _mulle_objc_cache *cache,
@@ -232,12 +298,42 @@ struct _mulle_objc_cacheentry   *
    _mulle_objc_cache_add_pointer_entry( struct _mulle_objc_cache *cache,
                                         void *pointer,
                                         mulle_objc_uniqueid_t uniqueid);
+
+// *p_added is 1, if pointer was written by this call, 0 if the returned
+// entry was filled by someone else
+struct _mulle_objc_cacheentry   *
+   __mulle_objc_cache_add_pointer_entry( struct _mulle_objc_cache *cache,
+                                         void *pointer,
+                                         mulle_objc_uniqueid_t uniqueid,
+                                         int *p_added);
 struct _mulle_objc_cacheentry   *
    _mulle_objc_cache_add_functionpointer_entry( struct _mulle_objc_cache *cache,
                                                 mulle_functionpointer_t pointer,
                                                 mulle_objc_uniqueid_t uniqueid);
 
 
+//
+// Called on the slow path after a cache miss has been added as "entry", this
+// records the miss and how far the entry landed from its home slot.
+//
+static inline void
+   _mulle_objc_cache_note_miss( struct _mulle_objc_cache *cache,
+                                struct _mulle_objc_cacheentry *entry,
+                                mulle_objc_uniqueid_t uniqueid)
+{
+   mulle_objc_cache_uint_t   offset;
+   mulle_objc_cache_uint_t   distance;
+
+   offset   = (mulle_objc_cache_uint_t) ((char *) entry - (char *) cache->entries);
+   distance = (offset - ((mulle_objc_cache_uint_t) uniqueid & cache->mask)) & cache->mask;
+
+   _mulle_atomic_pointer_increment( &cache->misses);
+   if( distance)
+      _mulle_atomic_pointer_add( &cache->probes,
+                                 (intptr_t) (distance / sizeof( struct _mulle_objc_cacheentry)));
+}
+
+
 # pragma mark - cache method lookup
 
 void   *_mulle_objc_cache_lookup_pointer( struct _mulle_objc_cache *cache,
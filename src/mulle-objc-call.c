@@ -40,6 +40,9 @@
 #include "mulle-objc-universe-class.h"
 #include "mulle-objc-methodlist.h"
 #include "mulle-objc-object.h"
+#include "mulle-objc-probe.h"
+#include "mulle-objc-profile.h"
+#include "mulle-objc-tracering.h"
 #include "mulle-objc-universe.h"
 
 #include "include-private.h"
@@ -64,6 +67,13 @@ static void   *_mulle_objc_object_call2_emptycache( void *obj,
 static void   *_mulle_objc_object_call2( void *obj,
                                          mulle_objc_methodid_t methodid,
                                          void *parameter);
+static void   *_mulle_objc_object_call2_instrumented( void *obj,
+                                                      mulle_objc_methodid_t methodid,
+                                                      void *parameter);
+static void   *_mulle_objc_object_call_class_instrumented( void *obj,
+                                                           mulle_objc_methodid_t methodid,
+                                                           void *parameter,
+                                                           struct _mulle_objc_class *cls);
 
 void   *_mulle_objc_object_call_class( void *obj,
                                        mulle_objc_methodid_t methodid,
@@ -209,6 +219,20 @@ static inline void
 //
 struct _mulle_objc_cacheentry  empty_entry;
 
+// with MULLE_OBJC_COUNT_METHOD_CACHE method caches count their hits
+static inline struct _mulle_objc_cache   *
+   _mulle_objc_universe_new_methodcache( struct _mulle_objc_universe *universe,
+                                         mulle_objc_cache_uint_t size)
+{
+   struct mulle_allocator   *allocator;
+
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   if( universe->debug.count.method_cache)
+      return( mulle_objc_cache_new_counting( size, allocator));
+   return( mulle_objc_cache_new( size, allocator));
+}
+
+
 MULLE_C_NEVER_INLINE struct _mulle_objc_cacheentry   *
    _mulle_objc_class_add_cacheentry_swappmethodcache( struct _mulle_objc_class *cls,
                                                       struct _mulle_objc_cache *cache,
@@ -238,7 +262,7 @@ MULLE_C_NEVER_INLINE struct _mulle_objc_cacheentry   *
 
    new_size  = _mulle_objc_cache_get_resize( old_cache, strategy);
    allocator = _mulle_objc_universe_get_allocator( universe);
-   cache     = mulle_objc_cache_new( new_size, allocator);
+   cache     = _mulle_objc_universe_new_methodcache( universe, new_size);
 
    // fill it up with preload messages and place our method there too
    // now for good measure
@@ -276,16 +300,32 @@ MULLE_C_NEVER_INLINE struct _mulle_objc_cacheentry   *
       return( NULL);
    }
 
+   MULLE_OBJC_PROBE5( methodcache__swap,
+                      cls,
+                      _mulle_objc_class_get_classid( cls),
+                      old_cache,
+                      cache,
+                      methodid);
+
    if( universe->debug.trace.method_cache)
-      mulle_objc_universe_trace( universe,
-                                 "new method cache %p "
-                                 "(%u of %u used) for %s %08x \"%s\"",
-                                 cache,
-                                 _mulle_objc_cache_get_count( cache),
-                                 old_cache->size,
-                                 _mulle_objc_class_get_classtypename( cls),
-                                 _mulle_objc_class_get_classid( cls),
-                                 _mulle_objc_class_get_name( cls));
+   {
+      if( _mulle_objc_universe_has_tracefile( universe))
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_methodcache_new,
+                                           _mulle_objc_class_get_classid( cls),
+                                           methodid,
+                                           cache);
+      else
+         mulle_objc_universe_trace( universe,
+                                    "new method cache %p "
+                                    "(%u of %u used) for %s %08x \"%s\"",
+                                    cache,
+                                    _mulle_objc_cache_get_count( cache),
+                                    old_cache->size,
+                                    _mulle_objc_class_get_classtypename( cls),
+                                    _mulle_objc_class_get_classid( cls),
+                                    _mulle_objc_class_get_name( cls));
+   }
 
    // ??? isn't this checked in the assert above already ?
    if( &old_cache->entries[ 0] == &cls->universe->empty_cache.entries[ 0])
@@ -326,18 +366,100 @@ MULLE_C_NEVER_INLINE struct _mulle_objc_cacheentry   *
    }
 
    if( universe->debug.trace.method_cache)
-      mulle_objc_universe_trace( universe, "free old method cache "
-                                  "%p (%u of %u used) for %s %08x \"%s\"",
+   {
+      if( _mulle_objc_universe_has_tracefile( universe))
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_methodcache_free,
+                                           _mulle_objc_class_get_classid( cls),
+                                           methodid,
+                                           old_cache);
+      else
+         mulle_objc_universe_trace( universe, "free old method cache "
+                                     "%p (%u of %u used) for %s %08x \"%s\"",
+                                    old_cache,
+                                     _mulle_objc_cache_get_count( cache),
+                                     old_cache->size,
+                                    _mulle_objc_class_get_classtypename( cls),
+                                    _mulle_objc_class_get_classid( cls),
+                                    _mulle_objc_class_get_name( cls));
+   }
+
+   _mulle_objc_cache_abafree( old_cache, allocator);
+
+   return( entry);
+}
+
+
+//
+// Like above, but the new cache gets the live entries of the old cache
+// rehashed into it. Entries added to the old cache while we copy may be
+// lost, they will be refilled on demand. Returns NULL, if someone else
+// swapped the cache.
+//
+MULLE_C_NEVER_INLINE struct _mulle_objc_cache   *
+   _mulle_objc_class_rehash_swappmethodcache( struct _mulle_objc_class *cls,
+                                              struct _mulle_objc_cache *cache,
+                                              mulle_objc_cache_uint_t new_size)
+{
+   struct _mulle_objc_cache        *old_cache;
+   struct _mulle_objc_cacheentry   *p;
+   struct _mulle_objc_cacheentry   *sentinel;
+   struct _mulle_objc_universe     *universe;
+   struct mulle_allocator          *allocator;
+   mulle_objc_uniqueid_t           copyid;
+   mulle_functionpointer_t         imp;
+
+   old_cache = cache;
+   universe  = _mulle_objc_class_get_universe( cls);
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   cache     = _mulle_objc_universe_new_methodcache( universe, new_size);
+
+   p        = &old_cache->entries[ 0];
+   sentinel = &p[ old_cache->size];
+   for( ; p < sentinel; ++p)
+   {
+      copyid = (mulle_objc_uniqueid_t) (intptr_t) _mulle_atomic_pointer_read( &p->key.pointer);
+      if( copyid == MULLE_OBJC_NO_UNIQUEID)
+         continue;
+
+      imp = _mulle_atomic_functionpointer_read( &p->value.functionpointer);
+      if( ! imp)
+         continue;
+
+      _mulle_objc_cache_inactivecache_add_functionpointer_entry( cache, imp, copyid);
+   }
+
+   if( _mulle_objc_cachepivot_atomiccas_entries( &cls->cachepivot.pivot,
+                                                 cache->entries,
+                                                 old_cache->entries))
+   {
+      _mulle_objc_cache_free( cache, allocator); // sic, was never visible
+      return( NULL);
+   }
+
+   MULLE_OBJC_PROBE5( methodcache__swap,
+                      cls,
+                      _mulle_objc_class_get_classid( cls),
+                      old_cache,
+                      cache,
+                      MULLE_OBJC_NO_METHODID);
+
+   if( universe->debug.trace.method_cache)
+      mulle_objc_universe_trace( universe,
+                                 "shrunk method cache %p (%u of %u used) "
+                                 "to %p (%u) for %s %08x \"%s\"",
                                  old_cache,
-                                  _mulle_objc_cache_get_count( cache),
-                                  old_cache->size,
+                                 _mulle_objc_cache_get_count( cache),
+                                 old_cache->size,
+                                 cache,
+                                 cache->size,
                                  _mulle_objc_class_get_classtypename( cls),
                                  _mulle_objc_class_get_classid( cls),
                                  _mulle_objc_class_get_name( cls));
 
    _mulle_objc_cache_abafree( old_cache, allocator);
 
-   return( entry);
+   return( cache);
 }
 
 
@@ -366,8 +488,8 @@ static struct _mulle_objc_cacheentry   *
                _mulle_objc_class_get_classtypename( cls), cls->name);
    }
 
-   // when we trace method calls, we don't cache ever
-   if( _mulle_objc_class_get_universe( cls)->debug.trace.method_call)
+   // when we trace or profile method calls, we don't cache ever
+   if( ! _mulle_objc_universe_should_cache_methods( universe))
       return( NULL);
 
    //
@@ -393,7 +515,11 @@ static struct _mulle_objc_cacheentry   *
                                                            (mulle_functionpointer_t) imp,
                                                            methodid);
       if( entry)
+      {
+         if( universe->config.adaptive_cache)
+            _mulle_objc_cache_note_miss( cache, entry, methodid);
          return( entry);
+      }
    }
 }
 
@@ -471,6 +597,13 @@ MULLE_C_NEVER_INLINE struct _mulle_objc_cacheentry   *
       return( NULL);
    }
 
+   MULLE_OBJC_PROBE5( supercache__swap,
+                      cls,
+                      _mulle_objc_class_get_classid( cls),
+                      old_cache,
+                      cache,
+                      superid);
+
    if( universe->debug.trace.method_cache)
       mulle_objc_universe_trace( universe, "new search cache %p for "
                                  "%s %08x \"%s\" with %u entries",
@@ -513,9 +646,9 @@ MULLE_C_NEVER_INLINE static struct _mulle_objc_cacheentry *
    // need to check that we are initialized
    if( _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_NO_SEARCH_CACHE))
       return( NULL);
-   // when we trace method calls, we don't cache ever
+   // when we trace or profile method calls, we don't cache ever
    universe = _mulle_objc_class_get_universe( cls);
-   if( universe->debug.trace.method_call)
+   if( ! _mulle_objc_universe_should_cache_methods( universe))
       return( NULL);
    // some special classes may choose to never cache
    if( _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_ALWAYS_EMPTY_CACHE))
@@ -728,10 +861,36 @@ MULLE_C_NEVER_INLINE static void *
    mulle_objc_implementation_t   imp;
    struct _mulle_objc_universe   *universe;
 
-   imp      = _mulle_objc_class_lookup_implementation_nofail( cls, methodid);
    universe = _mulle_objc_class_get_universe( cls);
+#if DEBUG
+   // the cache of a quiescent thread may already have been freed
+   if( _mulle_objc_thread_is_quiescent_universe_gc( universe))
+      mulle_objc_universe_fail_inconsistency( universe,
+            "mulle_objc_universe: thread %p messages while quiescent (missing mulle_objc_thread_leave_quiescence ?)",
+            (void *) mulle_thread_self());
+#endif
+   imp = _mulle_objc_class_lookup_implementation_nofail( cls, methodid);
    if( universe->debug.trace.method_call)
-      mulle_objc_class_trace_call( cls, obj, methodid, parameter, imp);
+   {
+      if( _mulle_objc_universe_has_tracefile( universe))
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_method_call,
+                                           _mulle_objc_class_get_classid( cls),
+                                           methodid,
+                                           imp);
+      else
+         mulle_objc_class_trace_call( cls, obj, methodid, parameter, imp);
+   }
+   //
+   // the call functions tail-call into here, so the return address is
+   // usually in the method that sent the message
+   //
+   if( universe->debug.profile.method_call)
+      _mulle_objc_universe_profile_call( universe,
+                                         cls,
+                                         methodid,
+                                         imp,
+                                         __builtin_return_address( 0));
    /*->*/
    return( (*imp)( obj, methodid, parameter));
 }
@@ -911,8 +1070,8 @@ mulle_objc_implementation_t
    method   = mulle_objc_class_search_method_nofail( cls, methodid);
    imp      = _mulle_objc_method_get_implementation( method);
    universe = _mulle_objc_class_get_universe( cls);
-   // trace but don't cache it
-   if( universe->debug.trace.method_call)
+   // trace or profile but don't cache it
+   if( ! _mulle_objc_universe_should_cache_methods( universe))
       return( imp);
    // some special classes may choose to never cache
    if( _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_ALWAYS_EMPTY_CACHE))
@@ -1035,6 +1194,115 @@ void   *_mulle_objc_object_call2( void *obj,
 }
 
 
+MULLE_C_ALWAYS_INLINE
+static inline void   _mulle_objc_class_profile_hit( struct _mulle_objc_class *cls,
+                                                    mulle_objc_methodid_t methodid,
+                                                    mulle_objc_implementation_t imp,
+                                                    void *caller)
+{
+   struct _mulle_objc_universe   *universe;
+
+   universe = _mulle_objc_class_get_universe( cls);
+   if( universe->debug.profile.method_call)
+      _mulle_objc_universe_profile_call( universe, cls, methodid, imp, caller);
+}
+
+
+//
+// Variants of the two functions above, that are used with
+// MULLE_OBJC_COUNT_METHOD_CACHE and MULLE_OBJC_PROFILE_METHOD_CALL. They
+// count the hits per cache entry and sample the calls. Misses are sampled
+// by _mulle_objc_object_call_class_nofail. Hits on the first slot, that
+// are resolved by the inlined mulle_objc_object_call_inline, can not be
+// seen.
+//
+static void   *_mulle_objc_object_call_class_instrumented( void *obj,
+                                                           mulle_objc_methodid_t methodid,
+                                                           void *parameter,
+                                                           struct _mulle_objc_class *cls)
+{
+   mulle_objc_implementation_t      imp;
+   mulle_functionpointer_t          p;
+   struct _mulle_objc_cache         *cache;
+   struct _mulle_objc_cacheentry    *entries;
+   struct _mulle_objc_cacheentry    *entry;
+   mulle_objc_cache_uint_t          mask;
+   mulle_objc_cache_uint_t          offset;
+
+   assert( obj);
+   assert( mulle_objc_uniqueid_is_sane( methodid));
+
+   entries = _mulle_objc_cachepivot_atomicget_entries( &cls->cachepivot.pivot);
+   cache   = _mulle_objc_cacheentry_get_cache_from_entries( entries);
+   mask    = cache->mask;
+
+   offset  = (mulle_objc_cache_uint_t) methodid;
+   for(;;)
+   {
+      offset = offset & mask;
+      entry  = (void *) &((char *) entries)[ offset];
+
+      if( entry->key.uniqueid == methodid)
+      {
+         _mulle_objc_cache_count_hit( cache, entry);
+         p       = _mulle_atomic_functionpointer_nonatomic_read( &entry->value.functionpointer);
+         imp     = (mulle_objc_implementation_t) p;
+         _mulle_objc_class_profile_hit( cls, methodid, imp, __builtin_return_address( 0));
+/*->*/   return( (*imp)( obj, methodid, parameter));
+      }
+
+      if( ! entry->key.uniqueid)
+         break;
+
+      offset += sizeof( struct _mulle_objc_cacheentry);
+   }
+/*->*/
+   return( _mulle_objc_object_call_class_nofail( obj, methodid, parameter, cls));
+}
+
+
+static void   *_mulle_objc_object_call2_instrumented( void *obj,
+                                                      mulle_objc_methodid_t methodid,
+                                                      void *parameter)
+{
+   mulle_objc_implementation_t      imp;
+   mulle_functionpointer_t          p;
+   struct _mulle_objc_cache         *cache;
+   struct _mulle_objc_cacheentry    *entries;
+   struct _mulle_objc_cacheentry    *entry;
+   struct _mulle_objc_class         *cls;
+   mulle_objc_cache_uint_t          mask;
+   mulle_objc_cache_uint_t          offset;
+
+   assert( mulle_objc_uniqueid_is_sane( methodid));
+
+   cls     = _mulle_objc_object_get_isa( obj);
+   entries = _mulle_objc_cachepivot_atomicget_entries( &cls->cachepivot.pivot);
+   cache   = _mulle_objc_cacheentry_get_cache_from_entries( entries);
+   mask    = cache->mask;
+
+   offset  = (mulle_objc_cache_uint_t) methodid;
+   do
+   {
+      offset += sizeof( struct _mulle_objc_cacheentry);
+      offset  = offset & mask;
+      entry   = (void *) &((char *) entries)[ offset];
+      if( entry->key.uniqueid == methodid)
+      {
+         _mulle_objc_cache_count_hit( cache, entry);
+         p       = _mulle_atomic_functionpointer_nonatomic_read( &entry->value.functionpointer);
+         imp     = (mulle_objc_implementation_t) p;
+         _mulle_objc_class_profile_hit( cls, methodid, imp, __builtin_return_address( 0));
+/*->*/
+         return( (*imp)( obj, methodid, parameter));
+      }
+   }
+   while( entry->key.uniqueid);
+/*->*/
+   return( _mulle_objc_object_call_class_nofail( obj, methodid, parameter, cls));
+}
+
+
 //
 // this function is called, when the first inline cache check gave a
 // collision
@@ -1096,7 +1364,6 @@ static void   _mulle_objc_class_setup_initial_cache( struct _mulle_objc_class *c
 {
    struct _mulle_objc_universe   *universe;
    struct _mulle_objc_cache      *cache;
-   struct mulle_allocator        *allocator;
    mulle_objc_cache_uint_t       n_entries;
    void                          *found;
 
@@ -1110,8 +1377,7 @@ static void   _mulle_objc_class_setup_initial_cache( struct _mulle_objc_class *c
 
    if( ! _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_ALWAYS_EMPTY_CACHE))
    {
-      allocator = _mulle_objc_universe_get_allocator( universe);
-      cache     = mulle_objc_cache_new( n_entries, allocator);
+      cache = _mulle_objc_universe_new_methodcache( universe, n_entries);
 
       assert( cache);
 
@@ -1126,18 +1392,32 @@ static void   _mulle_objc_class_setup_initial_cache( struct _mulle_objc_class *c
 
       cls->cachepivot.call2 = _mulle_objc_object_call2;
       cls->call             = _mulle_objc_object_call_class;
+      if( universe->debug.count.method_cache || universe->debug.profile.method_call)
+      {
+         cls->cachepivot.call2 = _mulle_objc_object_call2_instrumented;
+         cls->call             = _mulle_objc_object_call_class_instrumented;
+      }
       cls->superlookup      = _mulle_objc_class_superlookup_implementation;
       cls->superlookup2     = _mulle_objc_class_superlookup2_implementation_nofail;
 
       if( universe->debug.trace.method_cache)
-         mulle_objc_universe_trace( universe, "new initial cache %p "
-                                    "on %s %08x \"%s\" (%p) with %u entries",
-                                    cache,
-                                    _mulle_objc_class_get_classtypename( cls),
-                                    _mulle_objc_class_get_classid( cls),
-                                    _mulle_objc_class_get_name( cls),
-                                    cls,
-                                    cache->size);
+      {
+         if( _mulle_objc_universe_has_tracefile( universe))
+            _mulle_objc_universe_trace_event( universe,
+                                              mulle_objc_traceevent_methodcache_initial,
+                                              _mulle_objc_class_get_classid( cls),
+                                              0,
+                                              cache);
+         else
+            mulle_objc_universe_trace( universe, "new initial cache %p "
+                                       "on %s %08x \"%s\" (%p) with %u entries",
+                                       cache,
+                                       _mulle_objc_class_get_classtypename( cls),
+                                       _mulle_objc_class_get_classid( cls),
+                                       _mulle_objc_class_get_name( cls),
+                                       cls,
+                                       cache->size);
+      }
    }
    else
    {
@@ -1231,6 +1511,10 @@ static void
                                  "call +[%s initialize]",
                                  _mulle_objc_metaclass_get_name( meta));
 
+   MULLE_OBJC_PROBE2( initialize__start,
+                      infra,
+                      _mulle_objc_infraclass_get_classid( infra));
+
    imp   = _mulle_objc_method_get_implementation( initialize);
    if( universe->debug.trace.method_call)
       mulle_objc_class_trace_call( &infra->base,
@@ -1242,6 +1526,10 @@ static void
            MULLE_OBJC_INITIALIZE_METHODID,
            NULL);
 
+   MULLE_OBJC_PROBE2( initialize__done,
+                      infra,
+                      _mulle_objc_infraclass_get_classid( infra));
+
    if( universe->debug.trace.initialize)
       mulle_objc_universe_trace( universe,
                                  "done +[%s initialize]",
@@ -86,6 +86,7 @@ MULLE_C_ALWAYS_INLINE static inline void  *
    //
    // with tagged pointers inlining starts to become useless, because this
    // _mulle_objc_object_get_isa function produces too much code IMO
+   // (try MULLE_OBJC_CALL_BRANCHFREE_ISA)
    //
    cls = _mulle_objc_object_get_isa( obj);
 
@@ -272,6 +273,7 @@ MULLE_C_ALWAYS_INLINE static inline void  *
    //
    // with tagged pointers inlining starts to become useless, because this
    // _mulle_objc_object_get_isa function produces too much code IMO
+   // (try MULLE_OBJC_CALL_BRANCHFREE_ISA)
    //
    cls = _mulle_objc_object_get_isa( obj);
 
@@ -346,6 +348,12 @@ struct _mulle_objc_cacheentry *
                                                       mulle_objc_methodid_t methodid,
                                                       enum mulle_objc_cachesizing_t sizing);
 
+// internal, used by _mulle_objc_class_shrink_methodcache
+struct _mulle_objc_cache   *
+   _mulle_objc_class_rehash_swappmethodcache( struct _mulle_objc_class *cls,
+                                              struct _mulle_objc_cache *cache,
+                                              mulle_objc_cache_uint_t new_size);
+
 MULLE_C_NEVER_INLINE
 struct _mulle_objc_cacheentry   *
    _mulle_objc_class_add_cacheentry_swapsupercache( struct _mulle_objc_class *cls,
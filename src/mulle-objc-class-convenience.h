@@ -36,6 +36,7 @@
 #ifndef mulle_objc_class_convenience_h__
 #define mulle_objc_class_convenience_h__
 
+#include "mulle-objc-allocstats.h"
 #include "mulle-objc-class.h"
 #include "mulle-objc-classpair.h"
 #include "mulle-objc-universe.h"
@@ -70,6 +71,11 @@ static inline void *
    cls    = _mulle_objc_infraclass_as_class( infra);
    _mulle_objc_object_set_isa( obj, cls);
 
+#ifdef MULLE_OBJC_ALLOCSTATS
+   if( _mulle_atomic_pointer_read( &_mulle_objc_class_get_universe( cls)->debug.count.instance_alloc))
+      _mulle_objc_infraclass_count_alloc( infra, size);
+#endif
+
 // only add this trace query for debugging because it slows things down!
 #if DEBUG
    {
@@ -44,6 +44,7 @@
 #include "mulle-objc-metaclass.h"
 #include "mulle-objc-method.h"
 #include "mulle-objc-methodlist.h"
+#include "mulle-objc-probe.h"
 #include "mulle-objc-super.h"
 #include "mulle-objc-universe.h"
 
@@ -667,6 +668,10 @@ struct _mulle_objc_method   *
                                                                       search->args.methodid));
 
       assert( result->error == ENOENT);
+      MULLE_OBJC_PROBE3( method__search__miss,
+                         cls,
+                         _mulle_objc_class_get_classid( cls),
+                         search->args.methodid);
       if( trace)
          trace_method_search_fail( cls, search, ENOENT);
 
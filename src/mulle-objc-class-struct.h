@@ -113,6 +113,17 @@ enum _mulle_objc_class_state
 };
 
 
+//
+// The display holds the ancestors of a class indexed by their depth, the
+// class itself being the last entry. With it a subclass check is a bounds
+// check and a compare. Hierarchies deeper than the display fall back to
+// walking the superclass chain.
+//
+#ifndef MULLE_OBJC_CLASS_DISPLAY_SIZE
+# define MULLE_OBJC_CLASS_DISPLAY_SIZE  8
+#endif
+
+
 //
 // this is a fairly hefty struct, and the universe needs two for each class
 // assume that each new class costs you 1K.
@@ -157,6 +168,9 @@ struct _mulle_objc_class
 
    uintptr_t                               extensionoffset;  // 4 later #1#
 
+   uint16_t                                depth;            // root is 0
+   struct _mulle_objc_class                *display[ MULLE_OBJC_CLASS_DISPLAY_SIZE];
+
    struct _mulle_objc_method               *forwardmethod;
 
    mulle_atomic_pointer_t                  state;
@@ -335,11 +349,46 @@ static inline char   *_mulle_objc_class_get_classtypename( struct _mulle_objc_cl
 // to be used for class setup only
 
 
+//
+// the display of the superclass must be setup already, subclasses of cls
+// are not updated
+//
+static inline void
+   _mulle_objc_class_set_display( struct _mulle_objc_class *cls)
+{
+   struct _mulle_objc_class   *superclass;
+   unsigned int               i;
+   unsigned int               n;
+
+   superclass = cls->superclass;
+   if( ! superclass)
+   {
+      cls->depth       = 0;
+      cls->display[ 0] = cls;
+      return;
+   }
+
+   cls->depth = superclass->depth + 1;
+
+   n = superclass->depth + 1;
+   if( n > MULLE_OBJC_CLASS_DISPLAY_SIZE)
+      n = MULLE_OBJC_CLASS_DISPLAY_SIZE;
+   for( i = 0; i < n; i++)
+      cls->display[ i] = superclass->display[ i];
+   for( ; i < MULLE_OBJC_CLASS_DISPLAY_SIZE; i++)
+      cls->display[ i] = NULL;
+
+   if( cls->depth < MULLE_OBJC_CLASS_DISPLAY_SIZE)
+      cls->display[ cls->depth] = cls;
+}
+
+
 static inline void
    _mulle_objc_class_set_superclass( struct _mulle_objc_class *cls,
                                      struct _mulle_objc_class *superclass)
 {
    cls->superclass = superclass;
+   _mulle_objc_class_set_display( cls);
 }
 
 
@@ -47,6 +47,7 @@
 #include "mulle-objc-methodlist.h"
 #include "mulle-objc-universe.h"
 #include "mulle-objc-taggedpointer.h"
+#include "mulle-objc-tracering.h"
 
 #include <assert.h>
 #include <errno.h>
@@ -153,6 +154,7 @@ void   _mulle_objc_class_init( struct _mulle_objc_class *cls,
       cls->inheritance   = universe->classdefaults.inheritance;
 
    }
+   _mulle_objc_class_set_display( cls);
    //   cls->nextclass        = superclass;
    cls->classid          = classid;
    cls->allocationsize   = sizeof( struct _mulle_objc_objectheader) + instancesize;
@@ -331,6 +333,45 @@ int   _mulle_objc_class_invalidate_methodcacheentry( struct _mulle_objc_class *c
 }
 
 
+//
+// A cache that is less than a quarter full, is swapped for one of half the
+// size, with the live entries rehashed into it. A hot cache that is full
+// is left alone, as would be a cache that would immediately need to grow
+// again.
+//
+int   _mulle_objc_class_shrink_methodcache( struct _mulle_objc_class *cls)
+{
+   struct _mulle_objc_cache      *cache;
+   struct _mulle_objc_universe   *universe;
+   mulle_objc_cache_uint_t       n;
+   mulle_objc_cache_uint_t       new_size;
+
+   if( ! _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_CACHE_READY))
+      return( 0);
+   if( _mulle_objc_class_get_state_bit( cls, MULLE_OBJC_CLASS_ALWAYS_EMPTY_CACHE))
+      return( 0);
+
+   universe = _mulle_objc_class_get_universe( cls);
+   cache    = _mulle_objc_class_get_methodcache( cls);
+   if( &cache->entries[ 0] == &universe->empty_cache.entries[ 0])
+      return( 0);
+
+   if( cache->size <= MULLE_OBJC_MIN_CACHE_SIZE)
+      return( 0);
+
+   n = _mulle_objc_cache_get_count( cache);
+   if( n * 4 >= cache->size)
+      return( 0);
+
+   new_size = (mulle_objc_cache_uint_t) _mulle_objc_cache_get_resize( cache, MULLE_OBJC_CACHESIZE_SHRINK);
+   if( _mulle_objc_universe_get_cachesize_for_count( universe, n) > new_size)
+      return( 0);
+
+   // if we get NULL, someone else swapped the cache, fine by us
+   return( _mulle_objc_class_rehash_swappmethodcache( cls, cache, new_size) != NULL);
+}
+
+
 #ifdef HAVE_SUPERCACHE
 int   _mulle_objc_class_invalidate_supercache( struct _mulle_objc_class *cls)
 {
@@ -833,7 +874,20 @@ void   _mulle_objc_class_trace_alloc_instance( struct _mulle_objc_class *cls,
                                                void *obj,
                                                size_t extra)
 {
-   mulle_objc_universe_fprintf( _mulle_objc_class_get_universe( cls),
+   struct _mulle_objc_universe   *universe;
+
+   universe = _mulle_objc_class_get_universe( cls);
+   if( _mulle_objc_universe_has_tracefile( universe))
+   {
+      _mulle_objc_universe_trace_event( universe,
+                                        mulle_objc_traceevent_instance_alloc,
+                                        _mulle_objc_class_get_classid( cls),
+                                        (uint32_t) extra,
+                                        obj);
+      return;
+   }
+
+   mulle_objc_universe_fprintf( universe,
                      stderr,
                      "[==] %p instance %p allocated (\"%s\" (%08x)) ",
                      _mulle_objc_object_get_objectheader( obj),
@@ -78,20 +78,43 @@ int   _mulle_objc_class_is_sane( struct _mulle_objc_class *cls);
 
 # pragma mark - convenience accessors
 
+static inline unsigned int
+   _mulle_objc_class_get_depth( struct _mulle_objc_class *cls)
+{
+   return( cls->depth);
+}
+
+
+// kept for compatibility, this used to walk the superclasses
 static inline unsigned int
    _mulle_objc_class_count_depth( struct _mulle_objc_class *cls)
+{
+   return( _mulle_objc_class_get_depth( cls));
+}
+
+
+//
+// returns 1 if other is cls or one of its superclasses. For hierarchies
+// not deeper than MULLE_OBJC_CLASS_DISPLAY_SIZE, this is a bounds check and
+// a compare.
+//
+static inline int
+   _mulle_objc_class_is_subclass_of_class( struct _mulle_objc_class *cls,
+                                           struct _mulle_objc_class *other)
 {
    unsigned int   depth;
+   unsigned int   n;
 
-   depth = (unsigned int) -1;
-   do
-   {
-      ++depth;
-      cls = _mulle_objc_class_get_superclass( cls);
-   }
-   while( cls);
+   depth = other->depth;
+   if( depth < MULLE_OBJC_CLASS_DISPLAY_SIZE)
+      return( depth <= cls->depth && cls->display[ depth] == other);
 
-   return( depth);
+   if( depth > cls->depth)
+      return( 0);
+
+   for( n = cls->depth - depth; n; --n)
+      cls = _mulle_objc_class_get_superclass( cls);
+   return( cls == other);
 }
 
 
@@ -115,6 +138,9 @@ static inline void
    _mulle_objc_class_invalidate_methodcacheentry( cls, MULLE_OBJC_NO_METHODID);
 }
 
+// returns 1 if the cache was replaced by a smaller, empty one
+int   _mulle_objc_class_shrink_methodcache( struct _mulle_objc_class *cls);
+
 
 //static inline struct _mulle_objc_cache   *_mulle_objc_class_get_supercache( struct _mulle_objc_class *cls)
 //{
@@ -178,6 +204,20 @@ static inline struct _mulle_objc_kvcinfo  *
 }
 
 
+static inline struct _mulle_objc_kvcinfo  *
+   _mulle_objc_class_lookup_kvcinfo_keyid( struct _mulle_objc_class *cls,
+                                           char  *key,
+                                           mulle_objc_uniqueid_t keyid)
+{
+   struct _mulle_objc_kvccachepivot   *pivot;
+   struct _mulle_objc_kvccache        *cache;
+
+   pivot = _mulle_objc_class_get_kvccachepivot( cls);
+   cache = _mulle_objc_kvccachepivot_atomicget_cache( pivot);
+   return( _mulle_objc_kvccache_lookup_kvcinfo_keyid( cache, key, keyid));
+}
+
+
 static inline void
    _mulle_objc_class_invalidate_kvccache( struct _mulle_objc_class *cls)
 {
@@ -286,6 +326,16 @@ static inline struct _mulle_objc_class   *
 }
 
 
+static inline int
+   mulle_objc_class_is_subclass_of_class( struct _mulle_objc_class *cls,
+                                          struct _mulle_objc_class *other)
+{
+   if( ! cls || ! other)
+      return( 0);
+   return( _mulle_objc_class_is_subclass_of_class( cls, other));
+}
+
+
 static inline mulle_objc_classid_t
    mulle_objc_class_get_classid( struct _mulle_objc_class *cls)
 {
@@ -66,8 +66,9 @@ void    _mulle_objc_classpair_plusinit( struct _mulle_objc_classpair *pair,
 void    _mulle_objc_classpair_plusdone( struct _mulle_objc_classpair *pair,
                                         struct mulle_allocator *allocator)
 {
-   struct _mulle_objc_uniqueidarray   *array;
-   struct _mulle_objc_universe        *universe;
+   struct _mulle_objc_uniqueidarray     *array;
+   struct _mulle_objc_universe          *universe;
+   struct _mulle_objc_infraclassindex   *index;
 
    universe = _mulle_objc_classpair_get_universe( pair);
    assert( universe);
@@ -82,6 +83,10 @@ void    _mulle_objc_classpair_plusdone( struct _mulle_objc_classpair *pair,
    if( array != &universe->empty_uniqueidarray)
       mulle_objc_uniqueidarray_abafree( array, allocator);
 
+   index = _mulle_atomic_pointer_nonatomic_read( &pair->protocolindex);
+   if( index)
+      _mulle_objc_infraclassindex_free( index, allocator);
+
    _mulle_concurrent_pointerarray_done( &pair->protocolclasses);
 }
 
@@ -161,18 +166,19 @@ void  _mulle_objc_classpair_set_uniqueidarray( struct _mulle_objc_classpair *pai
    void                          *old;
    struct mulle_allocator        *allocator;
    struct _mulle_objc_universe   *universe;
-   unsigned int                  i;
 
    do
       old = _mulle_atomic_pointer_read( pointer);
    while( ! _mulle_atomic_pointer_weakcas( pointer, array, old));
 
-   if( array == &universe->empty_uniqueidarray)
+   universe = _mulle_objc_classpair_get_universe( pair);
+   _mulle_atomic_pointer_increment( &universe->indexgeneration);
+
+   if( old == &universe->empty_uniqueidarray)
       return;
 
-   universe  = _mulle_objc_classpair_get_universe( pair);
    allocator = _mulle_objc_universe_get_allocator( universe);
-   mulle_objc_uniqueidarray_abafree( array, allocator);
+   mulle_objc_uniqueidarray_abafree( old, allocator);
 }
 
 
@@ -202,6 +208,8 @@ void  _mulle_objc_classpair_add_uniqueidarray_ids( struct _mulle_objc_classpair
    }
    while( ! _mulle_atomic_pointer_weakcas( pointer, copy, array));
 
+   _mulle_atomic_pointer_increment( &universe->indexgeneration);
+
    if( array != &universe->empty_uniqueidarray)
       mulle_objc_uniqueidarray_abafree( array, allocator);
 
@@ -582,6 +590,79 @@ int   __mulle_objc_classpair_conformsto_protocolid( struct _mulle_objc_classpair
 }
 
 
+//
+// the value is the classpair, that declares the protocol
+//
+static struct _mulle_objc_infraclassindex   *
+   _mulle_objc_classpair_build_protocolindex( struct _mulle_objc_infraclass *infra,
+                                              uintptr_t generation)
+{
+   struct _mulle_objc_infraclassindex   *index;
+   struct _mulle_objc_classpair         *pair;
+   struct _mulle_objc_classpair         *p;
+   struct _mulle_objc_infraclass        *superclass;
+   struct _mulle_objc_uniqueidarray     *array;
+   struct _mulle_objc_universe          *universe;
+   unsigned int                         n;
+   unsigned int                         i;
+   int                                  pass;
+
+   pair     = _mulle_objc_infraclass_get_classpair( infra);
+   universe = _mulle_objc_classpair_get_universe( pair);
+   index    = NULL;
+   n        = 0;
+
+   // first pass counts, second pass fills
+   for( pass = 0; pass < 2; pass++)
+   {
+      if( pass)
+      {
+         index = _mulle_objc_infraclassindex_new( generation, n, universe);
+         if( ! index)
+            return( NULL);
+      }
+
+      for( p = pair;;)
+      {
+         array = _mulle_atomic_pointer_read( &p->p_protocolids.pointer);
+         if( ! pass)
+            n += array->n;
+         else
+            for( i = 0; i < array->n; i++)
+               _mulle_objc_infraclassindex_add( index, p, array->entries[ i]);
+
+         infra = _mulle_objc_classpair_get_infraclass( p);
+         if( _mulle_objc_infraclass_get_inheritance( infra) & MULLE_OBJC_CLASS_DONT_INHERIT_SUPERCLASS)
+            break;
+
+         superclass = _mulle_objc_infraclass_get_superclass( infra);
+         if( ! superclass || superclass == infra)
+            break;
+         p = _mulle_objc_infraclass_get_classpair( superclass);
+      }
+   }
+   return( index);
+}
+
+
+int   _mulle_objc_classpair_conformsto_protocolid_indexed( struct _mulle_objc_classpair *pair,
+                                                           mulle_objc_protocolid_t protocolid)
+{
+   struct _mulle_objc_infraclassindex   *index;
+   struct _mulle_objc_infraclass        *infra;
+
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   index = _mulle_objc_infraclass_get_index( infra,
+                                             &pair->protocolindex,
+                                             _mulle_objc_classpair_build_protocolindex);
+   if( ! index)
+      return( __mulle_objc_classpair_conformsto_protocolid( pair,
+                                                            _mulle_objc_infraclass_get_inheritance( infra),
+                                                            protocolid));
+   return( _mulle_objc_cache_lookup_pointer( index->cache, protocolid) != NULL);
+}
+
+
 #pragma mark - protocollist
 
 void
@@ -79,6 +79,7 @@ struct _mulle_objc_classpair
    mulle_thread_mutex_t                      lock;   // used for initialize
    mulle_thread_t                            thread; // used for initialize
    struct _mulle_objc_loadclass              *loadclass;
+   mulle_atomic_pointer_t                    protocolindex; // lazy, see conformsto
 
    uint32_t                                  classindex;       // set when added
    double                                    _classextra[ 1];  // will not exist if classextra is 0
@@ -402,18 +403,20 @@ int
                                                  unsigned int inheritance,
                                                  mulle_objc_protocolid_t protocolid);
 
+//
+// Uses a set of all protocolids of the class and its superclasses, that is
+// built on first use and rebuilt after protocols have been added anywhere.
+// Falls back to __mulle_objc_classpair_conformsto_protocolid.
+//
+int
+   _mulle_objc_classpair_conformsto_protocolid_indexed( struct _mulle_objc_classpair *pair,
+                                                        mulle_objc_protocolid_t protocolid);
+
 static inline int
    _mulle_objc_classpair_conformsto_protocolid( struct _mulle_objc_classpair *pair,
                                                 mulle_objc_protocolid_t protocolid)
 {
-   struct _mulle_objc_infraclass   *infra;
-   unsigned int                    inheritance;
-
-   infra       = _mulle_objc_classpair_get_infraclass( pair);
-   inheritance = _mulle_objc_infraclass_get_inheritance( infra);
-   return( __mulle_objc_classpair_conformsto_protocolid( pair,
-                                                         inheritance,
-                                                         protocolid));
+   return( _mulle_objc_classpair_conformsto_protocolid_indexed( pair, protocolid));
 }
 
 
@@ -0,0 +1,434 @@
+//
+//  mulle-objc-epoch.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-epoch.h"
+
+#include "mulle-objc-universe-fail.h"
+
+#include "include-private.h"
+
+#include <errno.h>
+#include <string.h>
+
+
+# pragma mark - records
+
+static struct _mulle_objc_epochrecord   *
+   _mulle_objc_epochgc_get_current_record( struct _mulle_objc_epochgc *gc)
+{
+   return( mulle_thread_tss_get( gc->recordkey));
+}
+
+
+//
+// publish the current global epoch in the record. If the epoch advanced
+// meanwhile, an advancing thread may have missed the store, so try again
+//
+static uintptr_t   _mulle_objc_epochrecord_observe( struct _mulle_objc_epochrecord *record,
+                                                    struct _mulle_objc_epochgc *gc)
+{
+   uintptr_t   epoch;
+
+   do
+   {
+      epoch = (uintptr_t) _mulle_atomic_pointer_read( &gc->epoch);
+      _mulle_atomic_pointer_write( &record->epoch, (void *) epoch);
+   }
+   while( epoch != (uintptr_t) _mulle_atomic_pointer_read( &gc->epoch));
+
+   return( epoch);
+}
+
+
+// also the destructor of the thread local, when a thread exits
+static void   _mulle_objc_epochrecord_release( struct _mulle_objc_epochrecord *record)
+{
+   _mulle_atomic_pointer_write( &record->epoch, NULL);
+   _mulle_atomic_pointer_write( &record->owner, NULL);
+}
+
+
+static struct _mulle_objc_epochrecord   *
+   _mulle_objc_epochgc_acquire_record( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+   struct _mulle_objc_epochrecord   *head;
+
+   // reuse records of exited threads, so the list doesn't grow forever
+   record = _mulle_atomic_pointer_read( &gc->records);
+   for( ; record; record = record->next)
+      if( ! _mulle_atomic_pointer_read( &record->owner))
+         if( _mulle_atomic_pointer_cas( &record->owner, record, NULL))
+            return( record);
+
+   record = mulle_allocator_calloc( &mulle_stdlib_allocator, 1, sizeof( *record));
+   _mulle_atomic_pointer_nonatomic_write( &record->owner, record);
+
+   do
+   {
+      head         = _mulle_atomic_pointer_read( &gc->records);
+      record->next = head;
+   }
+   while( ! _mulle_atomic_pointer_cas( &gc->records, record, head));
+
+   return( record);
+}
+
+
+# pragma mark - limbo
+
+static size_t   _mulle_objc_epochgc_free_nodes( struct _mulle_objc_epochgc *gc,
+                                                struct _mulle_objc_epochnode *node)
+{
+   struct _mulle_objc_epochnode   *next;
+   size_t                         bytes;
+   size_t                         n;
+
+   bytes = 0;
+   n     = 0;
+   for( ; node; node = next)
+   {
+      next = node->next;
+      (*node->p_free)( node->pointer);
+      bytes += node->size;
+      ++n;
+      mulle_allocator_free( &mulle_stdlib_allocator, node);
+   }
+
+   if( n)
+   {
+      _mulle_atomic_pointer_add( &gc->pending_bytes, -(intptr_t) bytes);
+      _mulle_atomic_pointer_add( &gc->pending_count, -(intptr_t) n);
+   }
+   return( bytes);
+}
+
+
+//
+// All active threads must have observed the current epoch E. Then nothing
+// retired in E - 2 can still be seen. That limbo list is detached before
+// E + 1 is published, as it is reused for E + 1.
+//
+static size_t   _mulle_objc_epochgc_try_advance( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+   struct _mulle_objc_epochnode     *nodes;
+   uintptr_t                        epoch;
+   uintptr_t                        observed;
+   size_t                           bytes;
+   int                              preserve;
+
+   preserve = errno;
+   if( mulle_thread_mutex_trylock( &gc->lock))
+   {
+      errno = preserve;
+      return( 0);
+   }
+
+   nodes = NULL;
+   epoch = (uintptr_t) _mulle_atomic_pointer_read( &gc->epoch);
+
+   record = _mulle_atomic_pointer_read( &gc->records);
+   for( ; record; record = record->next)
+   {
+      observed = (uintptr_t) _mulle_atomic_pointer_read( &record->epoch);
+      if( observed && observed != epoch)
+         break;
+   }
+
+   if( ! record)
+   {
+      nodes = _mulle_atomic_pointer_set( &gc->limbo[ (epoch + 1) % MULLE_OBJC_EPOCH_N_LIMBOS], NULL);
+      _mulle_atomic_pointer_write( &gc->epoch, (void *) (epoch + 1));
+   }
+   mulle_thread_mutex_unlock( &gc->lock);
+
+   bytes = _mulle_objc_epochgc_free_nodes( gc, nodes);
+   errno = preserve;
+   return( bytes);
+}
+
+
+size_t   _mulle_objc_epochgc_reclaim( struct _mulle_objc_epochgc *gc)
+{
+   size_t         bytes;
+   unsigned int   i;
+
+   bytes = 0;
+   for( i = 0; i < MULLE_OBJC_EPOCH_N_LIMBOS; i++)
+      bytes += _mulle_objc_epochgc_try_advance( gc);
+   return( bytes);
+}
+
+
+int   _mulle_objc_epochgc_retire( struct _mulle_objc_epochgc *gc,
+                                  void (*p_free)( void *),
+                                  void *pointer,
+                                  size_t size)
+{
+   struct _mulle_objc_epochrecord   *record;
+   struct _mulle_objc_epochnode     *node;
+   struct _mulle_objc_epochnode     *head;
+   mulle_atomic_pointer_t           *limbo;
+   uintptr_t                        epoch;
+   uintptr_t                        retired;
+   int                              quiescent;
+
+   if( ! pointer)
+      return( 0);
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( ! record)
+   {
+      errno = EINVAL;
+      return( -1);
+   }
+
+   node          = mulle_allocator_calloc( &mulle_stdlib_allocator, 1, sizeof( *node));
+   node->p_free  = p_free;
+   node->pointer = pointer;
+   node->size    = size;
+
+   // a quiescent thread becomes active for the duration of the retire, so
+   // that the epoch can't advance past the limbo list it picks
+   epoch     = (uintptr_t) _mulle_atomic_pointer_read( &record->epoch);
+   quiescent = ! epoch;
+   if( quiescent)
+      epoch = _mulle_objc_epochrecord_observe( record, gc);
+
+   limbo = &gc->limbo[ epoch % MULLE_OBJC_EPOCH_N_LIMBOS];
+   do
+   {
+      head       = _mulle_atomic_pointer_read( limbo);
+      node->next = head;
+   }
+   while( ! _mulle_atomic_pointer_cas( limbo, node, head));
+
+   _mulle_atomic_pointer_add( &gc->pending_bytes, (intptr_t) size);
+   _mulle_atomic_pointer_increment( &gc->pending_count);
+
+   if( quiescent)
+      _mulle_atomic_pointer_write( &record->epoch, NULL);
+
+   retired = (uintptr_t) _mulle_atomic_pointer_increment( &gc->retired);
+   if( ! ((retired + 1) & (MULLE_OBJC_EPOCH_RETIRE_ADVANCE - 1)))
+      _mulle_objc_epochgc_try_advance( gc);
+
+   return( 0);
+}
+
+
+int   _mulle_objc_epochgc_abafree( void *aba,
+                                   void (*p_free)( void *),
+                                   void *pointer)
+{
+   struct _mulle_objc_epochgc       *gc = aba;
+   struct _mulle_objc_epochrecord   *record;
+   size_t                           size;
+
+   size   = 0;
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( record)
+   {
+      size             = record->sizehint;
+      record->sizehint = 0;
+   }
+
+#if DEBUG
+   if( record && ! _mulle_atomic_pointer_read( &record->epoch))
+      mulle_objc_universe_fail_inconsistency( NULL,
+            "mulle_objc_universe: thread %p retires memory while quiescent (missing mulle_objc_thread_leave_quiescence ?)",
+            (void *) mulle_thread_self());
+#endif
+
+   if( _mulle_objc_epochgc_retire( gc, p_free, pointer, size))
+      mulle_objc_universe_fail_errno( NULL);
+   return( 0);
+}
+
+
+void   _mulle_objc_epochgc_set_sizehint( struct _mulle_objc_epochgc *gc,
+                                         size_t size)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( record)
+      record->sizehint = size;
+}
+
+
+# pragma mark - threads
+
+int   _mulle_objc_epochgc_register_current_thread( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( record)
+      return( 0);
+
+   record = _mulle_objc_epochgc_acquire_record( gc);
+   _mulle_objc_epochrecord_observe( record, gc);
+
+   if( mulle_thread_tss_set( gc->recordkey, record))
+   {
+      _mulle_objc_epochrecord_release( record);
+      return( -1);
+   }
+   return( 0);
+}
+
+
+void   _mulle_objc_epochgc_unregister_current_thread( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( ! record)
+      return;
+
+   mulle_thread_tss_set( gc->recordkey, NULL);
+   _mulle_objc_epochrecord_release( record);
+   _mulle_objc_epochgc_try_advance( gc);
+}
+
+
+int   _mulle_objc_epochgc_is_current_thread_registered( struct _mulle_objc_epochgc *gc)
+{
+   return( _mulle_objc_epochgc_get_current_record( gc) != NULL);
+}
+
+
+void   _mulle_objc_epochgc_checkin_current_thread( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( ! record)
+      return;
+
+   // the thread holds no references here, so a quiescent thread can
+   // safely become active again
+   _mulle_objc_epochrecord_observe( record, gc);
+   _mulle_objc_epochgc_try_advance( gc);
+}
+
+
+void   _mulle_objc_epochgc_enter_quiescence( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( ! record)
+      return;
+
+   _mulle_atomic_pointer_write( &record->epoch, NULL);
+   _mulle_objc_epochgc_try_advance( gc);
+}
+
+
+void   _mulle_objc_epochgc_leave_quiescence( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   if( record)
+      _mulle_objc_epochrecord_observe( record, gc);
+}
+
+
+int   _mulle_objc_epochgc_is_current_thread_quiescent( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+
+   record = _mulle_objc_epochgc_get_current_record( gc);
+   return( record && ! _mulle_atomic_pointer_read( &record->epoch));
+}
+
+
+# pragma mark - init/done
+
+int   _mulle_objc_epochgc_init( struct _mulle_objc_epochgc *gc)
+{
+   memset( gc, 0, sizeof( *gc));
+
+   if( mulle_thread_tss_create( (void *) _mulle_objc_epochrecord_release,
+                                &gc->recordkey))
+      return( -1);
+
+   if( mulle_thread_mutex_init( &gc->lock))
+   {
+      mulle_thread_tss_free( gc->recordkey);
+      return( -1);
+   }
+
+   _mulle_atomic_pointer_nonatomic_write( &gc->epoch, (void *) 1);
+   gc->enabled = 1;
+   return( 0);
+}
+
+
+void   _mulle_objc_epochgc_done( struct _mulle_objc_epochgc *gc)
+{
+   struct _mulle_objc_epochrecord   *record;
+   struct _mulle_objc_epochrecord   *next;
+   struct _mulle_objc_epochnode     *nodes;
+   unsigned int                     i;
+
+   if( ! gc->enabled)
+      return;
+
+   mulle_thread_tss_set( gc->recordkey, NULL);
+   mulle_thread_tss_free( gc->recordkey);
+
+   // no one else is running anymore, so everything can go
+   for( i = 0; i < MULLE_OBJC_EPOCH_N_LIMBOS; i++)
+   {
+      nodes = _mulle_atomic_pointer_set( &gc->limbo[ i], NULL);
+      _mulle_objc_epochgc_free_nodes( gc, nodes);
+   }
+
+   record = _mulle_atomic_pointer_read( &gc->records);
+   for( ; record; record = next)
+   {
+      next = record->next;
+      mulle_allocator_free( &mulle_stdlib_allocator, record);
+   }
+   _mulle_atomic_pointer_nonatomic_write( &gc->records, NULL);
+
+   mulle_thread_mutex_done( &gc->lock);
+   gc->enabled = 0;
+}
@@ -0,0 +1,187 @@
+//
+//  mulle-objc-epoch.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_epoch_h__
+#define mulle_objc_epoch_h__
+
+#include "include.h"
+
+
+//
+// Epoch based reclamation, enabled with MULLE_OBJC_EPOCH_GC. It replaces
+// the mulle-aba as the abafree of the universe allocator.
+//
+// With mulle-aba memory is only reclaimed, after every registered thread
+// has checked in. A thread that is blocked in I/O holds back everything.
+// Here each registered thread has a record with the epoch it last
+// observed. A thread that is about to block marks itself quiescent with
+// mulle_objc_thread_enter_quiescence and is then ignored, until it calls
+// mulle_objc_thread_leave_quiescence. A thread that has exited is quiescent
+// too. A checkin is a safe point, as the thread holds no references into
+// the runtime there, so it also leaves quiescence. In DEBUG builds a
+// quiescent thread, that misses the method cache or retires memory, fails
+// the universe, as it accesses the runtime without protection.
+//
+// Retired memory goes into one of three limbo lists, selected by the epoch
+// of the retiring thread. The global epoch advances, when all active
+// threads have observed it. Then the limbo list two epochs behind is freed.
+// Advancing is opportunistic: it is tried at checkin, on entering
+// quiescence, every MULLE_OBJC_EPOCH_RETIRE_ADVANCE retires and in
+// mulle_objc_universe_reclaim_epochgc, which a background thread can call.
+// Only one thread advances at a time, the others don't wait for it.
+//
+#ifndef MULLE_OBJC_EPOCH_RETIRE_ADVANCE
+# define MULLE_OBJC_EPOCH_RETIRE_ADVANCE   32   // power of 2
+#endif
+
+#define MULLE_OBJC_EPOCH_N_LIMBOS         3
+
+
+struct _mulle_objc_epochrecord
+{
+   struct _mulle_objc_epochrecord   *next;
+   mulle_atomic_pointer_t           epoch;   // 0: quiescent
+   mulle_atomic_pointer_t           owner;   // NULL: free for reuse
+   size_t                           sizehint;
+};
+
+
+struct _mulle_objc_epochnode
+{
+   struct _mulle_objc_epochnode   *next;
+   void                           (*p_free)( void *);
+   void                           *pointer;
+   size_t                         size;      // 0 if unknown
+};
+
+
+struct _mulle_objc_epochgc
+{
+   mulle_atomic_pointer_t   epoch;          // starts at 1, is never 0
+   mulle_atomic_pointer_t   records;        // struct _mulle_objc_epochrecord
+   mulle_atomic_pointer_t   limbo[ MULLE_OBJC_EPOCH_N_LIMBOS];  // struct _mulle_objc_epochnode
+   mulle_atomic_pointer_t   pending_bytes;
+   mulle_atomic_pointer_t   pending_count;
+   mulle_atomic_pointer_t   retired;        // for MULLE_OBJC_EPOCH_RETIRE_ADVANCE
+   mulle_thread_tss_t       recordkey;
+   mulle_thread_mutex_t     lock;           // held while advancing
+   unsigned int             enabled;
+};
+
+
+static inline int   _mulle_objc_epochgc_is_enabled( struct _mulle_objc_epochgc *gc)
+{
+   return( gc->enabled);
+}
+
+
+MULLE_C_NONNULL_FIRST
+int    _mulle_objc_epochgc_init( struct _mulle_objc_epochgc *gc);
+
+// frees everything still in limbo, only call when no other thread is active
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_done( struct _mulle_objc_epochgc *gc);
+
+
+// returns -1 and errno on failure
+MULLE_C_NONNULL_FIRST
+int    _mulle_objc_epochgc_register_current_thread( struct _mulle_objc_epochgc *gc);
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_unregister_current_thread( struct _mulle_objc_epochgc *gc);
+MULLE_C_NONNULL_FIRST
+int    _mulle_objc_epochgc_is_current_thread_registered( struct _mulle_objc_epochgc *gc);
+
+// also leaves quiescence
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_checkin_current_thread( struct _mulle_objc_epochgc *gc);
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_enter_quiescence( struct _mulle_objc_epochgc *gc);
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_leave_quiescence( struct _mulle_objc_epochgc *gc);
+
+// 0 if the current thread is not registered
+MULLE_C_NONNULL_FIRST
+int    _mulle_objc_epochgc_is_current_thread_quiescent( struct _mulle_objc_epochgc *gc);
+
+
+//
+// retire pointer, it will be freed with p_free, when no thread can see it
+// anymore. size is only used for the metrics and may be 0. Returns -1 and
+// errno, if the current thread is not registered.
+//
+MULLE_C_NONNULL_FIRST_SECOND
+int    _mulle_objc_epochgc_retire( struct _mulle_objc_epochgc *gc,
+                                   void (*p_free)( void *),
+                                   void *pointer,
+                                   size_t size);
+
+//
+// compatible with mulle_allocator abafree, with the epochgc as the aba.
+// Fails the universe, if the current thread is not registered or, in DEBUG
+// builds, if it is quiescent. As abafree
+// has no size parameter, a caller that knows the size of the block can set
+// a hint for the next abafree of the current thread.
+//
+int    _mulle_objc_epochgc_abafree( void *gc,
+                                    void (*p_free)( void *),
+                                    void *pointer);
+
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_epochgc_set_sizehint( struct _mulle_objc_epochgc *gc,
+                                         size_t size);
+
+//
+// tries to advance the epoch up to MULLE_OBJC_EPOCH_N_LIMBOS times, which
+// frees everything retired before the call, if all threads cooperate.
+// Returns the number of bytes freed.
+//
+MULLE_C_NONNULL_FIRST
+size_t   _mulle_objc_epochgc_reclaim( struct _mulle_objc_epochgc *gc);
+
+
+static inline size_t
+   _mulle_objc_epochgc_get_pending_bytes( struct _mulle_objc_epochgc *gc)
+{
+   return( (size_t) _mulle_atomic_pointer_read( &gc->pending_bytes));
+}
+
+
+static inline size_t
+   _mulle_objc_epochgc_get_pending_count( struct _mulle_objc_epochgc *gc)
+{
+   return( (size_t) _mulle_atomic_pointer_read( &gc->pending_count));
+}
+
+#endif
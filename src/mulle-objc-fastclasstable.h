@@ -45,15 +45,21 @@
 struct _mulle_objc_infraclass;
 
 
-// change compiler if you change this
-#define MULLE_OBJC_S_FASTCLASSES   64
+//
+// Change compiler if you change this. The size can be configured at build
+// time, but it must not exceed the number of entries generated into
+// "mulle-objc-fastclasstable-index.inc" (see bin/print-fastclasstable-index)
+//
+#ifndef MULLE_OBJC_S_FASTCLASSES
+# define MULLE_OBJC_S_FASTCLASSES   64
+#endif
 
 //
 // Adding more classes is relatively inexpensive, as this table is
 // only wired to the universe (vs. the fastmethodtable is on every class)
-// but of course you need to recompile the universe (and up the version)
-// Parts of this file should be autogenerated, when MULLE_OBJC_S_FASTCLASSES
-// is increased, but we ain't there yet.
+// but of course you need to recompile the universe (and up the version).
+// The classes register themselves with their universe during load, with
+// the fastclassindex of their loadclass.
 //
 struct _mulle_objc_fastclasstable
 {
@@ -96,118 +102,22 @@ static inline struct _mulle_objc_infraclass  *
 // By default there are no CLASSIDs configured. That is the job of the
 // Foundation. The Foundation should leave at least 50% free for user
 // classes. IMO. Obvious candidates are all the small clases, NSData, NSString
-// an obvious non-candidate would be NSFileManager.
+// an obvious non-candidate would be NSFileManager. To find the candidates
+// of your program, run it with MULLE_OBJC_COUNT_CLASS_LOOKUP=YES and check
+// "class-lookups.csv".
 //
 MULLE_C_CONST_RETURN MULLE_C_ALWAYS_INLINE
 static inline int   mulle_objc_get_fastclasstable_index( mulle_objc_classid_t classid)
 {
    switch( classid)
    {
-#ifdef MULLE_OBJC_FASTCLASSHASH_0
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_0 ) : return( 0);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_1
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_1 ) : return( 1);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_2
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_2 ) : return( 2);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_3
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_3 ) : return( 3);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_4
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_4 ) : return( 4);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_5
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_5 ) : return( 5);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_6
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_6 ) : return( 6);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_7
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_7 ) : return( 7);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_8
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_8 ) : return( 8);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_9
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_9 ) : return( 9);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_10
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_10) : return( 10);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_11
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_11) : return( 11);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_12
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_12) : return( 12);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_13
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_13) : return( 13);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_14
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_14) : return( 14);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_15
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_15) : return( 15);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_16
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_16) : return( 16);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_17
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_17) : return( 17);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_18
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_18) : return( 18);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_19
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_19) : return( 19);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_20
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_20) : return( 20);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_21
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_21) : return( 21);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_22
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_22) : return( 22);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_23
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_23) : return( 23);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_24
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_24) : return( 24);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_25
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_25) : return( 25);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_26
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_26) : return( 26);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_27
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_27) : return( 27);
-#endif
-
-#ifdef MULLE_OBJC_FASTCLASSHASH_28
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_28) : return( 28);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_29
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_29) : return( 29);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_30
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_30) : return( 30);
-#endif
-#ifdef MULLE_OBJC_FASTCLASSHASH_31
-      case MULLE_OBJC_CLASSID( MULLE_OBJC_FASTCLASSHASH_31) : return( 31);
-#endif
+#include "mulle-objc-fastclasstable-index.inc"
    }
    return( -1);
 }
 
+#if MULLE_OBJC_S_FASTCLASSES > MULLE_OBJC_S_FASTCLASSES_GENERATED
+# error "MULLE_OBJC_S_FASTCLASSES is too large, regenerate mulle-objc-fastclasstable-index.inc"
+#endif
+
 #endif /* mulle_objc_fastclasstable_h */
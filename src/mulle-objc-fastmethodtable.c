@@ -60,8 +60,10 @@ static void   *_mulle_objc_object_handle_fastmethodtablefault( void *obj,
    {
       imp = _mulle_objc_class_lookup_implementation_nocache( cls, methodid);
 
-      // don't cache it when tracing
-      if( ! universe->debug.trace.method_call)
+      // don't cache it when tracing or profiling, as the fast method
+      // table has no lookup to sample in
+      if( _mulle_objc_universe_should_cache_methods( universe) &&
+          ! universe->debug.profile.method_call)
          _mulle_atomic_pointer_write( &cls->vtab.methods[ index].pointer, imp);
    }
 
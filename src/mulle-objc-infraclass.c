@@ -35,6 +35,7 @@
 //
 #include "mulle-objc-infraclass.h"
 
+#include "mulle-objc-allocstats.h"
 #include "mulle-objc-class.h"
 #include "mulle-objc-class-search.h"
 #include "mulle-objc-classpair.h"
@@ -68,12 +69,44 @@ void    _mulle_objc_infraclass_plusinit( struct _mulle_objc_infraclass *infra,
 }
 
 
+void   _mulle_objc_infraclassindex_free( struct _mulle_objc_infraclassindex *index,
+                                        struct mulle_allocator *allocator)
+{
+   _mulle_objc_cache_free( index->cache, allocator);
+   mulle_allocator_free( allocator, index);
+}
+
+
+void   _mulle_objc_infraclassindex_abafree( struct _mulle_objc_infraclassindex *index,
+                                           struct mulle_allocator *allocator)
+{
+   _mulle_objc_cache_abafree( index->cache, allocator);
+   mulle_allocator_abafree( allocator, index);
+}
+
+
 void    _mulle_objc_infraclass_plusdone( struct _mulle_objc_infraclass *infra)
 {
+   struct _mulle_objc_infraclassindex   *index;
+   struct _mulle_objc_universe          *universe;
+   struct mulle_allocator               *allocator;
+
 #if 0
    // this is done earlier now
    _mulle_concurrent_hashmap_done( &infra->cvars);
 #endif
+   universe  = _mulle_objc_infraclass_get_universe( infra);
+   allocator = _mulle_objc_universe_get_allocator( universe);
+
+   index = _mulle_atomic_pointer_nonatomic_read( &infra->ivarindex);
+   if( index)
+      _mulle_objc_infraclassindex_free( index, allocator);
+   index = _mulle_atomic_pointer_nonatomic_read( &infra->propertyindex);
+   if( index)
+      _mulle_objc_infraclassindex_free( index, allocator);
+
+   _mulle_objc_infraclass_free_allocstats( infra);
+
    _mulle_concurrent_pointerarray_done( &infra->ivarlists);
 
    // initially room for 2 categories with properties
@@ -116,12 +149,193 @@ int   mulle_objc_infraclass_is_sane( struct _mulle_objc_infraclass *infra)
 }
 
 
+# pragma mark - ivar and property index
+
+struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclassindex_new( uintptr_t generation,
+                                    unsigned int n,
+                                    struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_infraclassindex   *index;
+   struct mulle_allocator               *allocator;
+   mulle_objc_cache_uint_t              size;
+
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   index     = mulle_allocator_malloc( allocator, sizeof( struct _mulle_objc_infraclassindex));
+   size      = _mulle_objc_universe_get_cachesize_for_count( universe, n);
+
+   index->generation = generation;
+   index->cache      = mulle_objc_cache_new( size, allocator);
+   return( index);
+}
+
+
+//
+// the first one added wins, as the lists are added subclass first and
+// the latest list first
+//
+void   _mulle_objc_infraclassindex_add( struct _mulle_objc_infraclassindex *index,
+                                       void *p,
+                                       mulle_objc_uniqueid_t uniqueid)
+{
+   struct _mulle_objc_cacheentry   *entry;
+   mulle_objc_cache_uint_t         offset;
+
+   offset = _mulle_objc_cache_find_entryoffset( index->cache, uniqueid);
+   entry  = (void *) &((char *) index->cache->entries)[ offset];
+   if( entry->key.uniqueid)
+      return;
+
+   _mulle_objc_cache_inactivecache_add_pointer_entry( index->cache, p, uniqueid);
+}
+
+
+static struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclass_build_ivarindex( struct _mulle_objc_infraclass *infra,
+                                           uintptr_t generation)
+{
+   struct _mulle_objc_infraclassindex                      *index;
+   struct _mulle_objc_infraclass                           *p;
+   struct _mulle_objc_ivarlist                             *list;
+   struct mulle_concurrent_pointerarrayreverseenumerator   rover;
+   unsigned int                                            n;
+   unsigned int                                            i;
+
+   n = 0;
+   for( p = infra; p; p = _mulle_objc_infraclass_get_superclass( p))
+   {
+      rover = mulle_concurrent_pointerarray_reverseenumerate( &p->ivarlists,
+                                                              mulle_concurrent_pointerarray_get_count( &p->ivarlists));
+      while( list = _mulle_concurrent_pointerarrayreverseenumerator_next( &rover))
+         n += list->n_ivars;
+      mulle_concurrent_pointerarrayreverseenumerator_done( &rover);
+   }
+
+   index = _mulle_objc_infraclassindex_new( generation, n, _mulle_objc_infraclass_get_universe( infra));
+   if( ! index)
+      return( NULL);
+
+   for( p = infra; p; p = _mulle_objc_infraclass_get_superclass( p))
+   {
+      rover = mulle_concurrent_pointerarray_reverseenumerate( &p->ivarlists,
+                                                              mulle_concurrent_pointerarray_get_count( &p->ivarlists));
+      while( list = _mulle_concurrent_pointerarrayreverseenumerator_next( &rover))
+         for( i = 0; i < list->n_ivars; i++)
+            _mulle_objc_infraclassindex_add( index,
+                                             &list->ivars[ i],
+                                             list->ivars[ i].descriptor.ivarid);
+      mulle_concurrent_pointerarrayreverseenumerator_done( &rover);
+   }
+   return( index);
+}
+
+
+static struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclass_build_propertyindex( struct _mulle_objc_infraclass *infra,
+                                               uintptr_t generation)
+{
+   struct _mulle_objc_infraclassindex                      *index;
+   struct _mulle_objc_infraclass                           *p;
+   struct _mulle_objc_propertylist                         *list;
+   struct mulle_concurrent_pointerarrayreverseenumerator   rover;
+   unsigned int                                            n;
+   unsigned int                                            i;
+
+   n = 0;
+   for( p = infra; p; p = _mulle_objc_infraclass_get_superclass( p))
+   {
+      rover = mulle_concurrent_pointerarray_reverseenumerate( &p->propertylists,
+                                                              mulle_concurrent_pointerarray_get_count( &p->propertylists));
+      while( list = _mulle_concurrent_pointerarrayreverseenumerator_next( &rover))
+         n += list->n_properties;
+      mulle_concurrent_pointerarrayreverseenumerator_done( &rover);
+   }
+
+   index = _mulle_objc_infraclassindex_new( generation, n, _mulle_objc_infraclass_get_universe( infra));
+   if( ! index)
+      return( NULL);
+
+   for( p = infra; p; p = _mulle_objc_infraclass_get_superclass( p))
+   {
+      rover = mulle_concurrent_pointerarray_reverseenumerate( &p->propertylists,
+                                                              mulle_concurrent_pointerarray_get_count( &p->propertylists));
+      while( list = _mulle_concurrent_pointerarrayreverseenumerator_next( &rover))
+         for( i = 0; i < list->n_properties; i++)
+            _mulle_objc_infraclassindex_add( index,
+                                             &list->properties[ i],
+                                             list->properties[ i].propertyid);
+      mulle_concurrent_pointerarrayreverseenumerator_done( &rover);
+   }
+   return( index);
+}
+
+
+//
+// returns NULL, if the index could not be built or someone else was
+// replacing it at the same time. Then just search the lists.
+// A thread, that isn't registered with the gc, must neither read an
+// index, that another thread may abafree, nor abafree one itself, so it
+// gets NULL too.
+//
+struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclass_get_index( struct _mulle_objc_infraclass *infra,
+                                     mulle_atomic_pointer_t *pointer,
+                                     struct _mulle_objc_infraclassindex *(*build)( struct _mulle_objc_infraclass *,
+                                                                                   uintptr_t))
+{
+   struct _mulle_objc_infraclassindex   *index;
+   struct _mulle_objc_infraclassindex   *old;
+   struct _mulle_objc_universe          *universe;
+   struct mulle_allocator               *allocator;
+   uintptr_t                            generation;
+
+   universe   = _mulle_objc_infraclass_get_universe( infra);
+   if( ! _mulle_objc_thread_isregistered_universe_gc( universe))
+      return( NULL);
+
+   generation = (uintptr_t) _mulle_atomic_pointer_read( &universe->indexgeneration);
+   old        = _mulle_atomic_pointer_read( pointer);
+   if( old && old->generation == generation)
+      return( old);
+
+   index = (*build)( infra, generation);
+   if( ! index || ! index->cache)
+   {
+      if( index)
+         mulle_allocator_free( _mulle_objc_universe_get_allocator( universe), index);
+      return( NULL);
+   }
+
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   if( ! _mulle_atomic_pointer_cas( pointer, index, old))
+   {
+      _mulle_objc_infraclassindex_free( index, allocator);
+      return( NULL);
+   }
+
+   if( old)
+      _mulle_objc_infraclassindex_abafree( old, allocator);
+   return( index);
+}
+
+
+static inline void
+   _mulle_objc_infraclass_bump_indexgeneration( struct _mulle_objc_infraclass *infra)
+{
+   struct _mulle_objc_universe   *universe;
+
+   universe = _mulle_objc_infraclass_get_universe( infra);
+   _mulle_atomic_pointer_increment( &universe->indexgeneration);
+}
+
+
 # pragma mark - properties
 //
 // doesn't check for duplicates
 //
-struct _mulle_objc_property   *_mulle_objc_infraclass_search_property( struct _mulle_objc_infraclass *infra,
-                                                                       mulle_objc_propertyid_t propertyid)
+static struct _mulle_objc_property   *
+   __mulle_objc_infraclass_search_property( struct _mulle_objc_infraclass *infra,
+                                            mulle_objc_propertyid_t propertyid)
 {
    struct _mulle_objc_property                             *property;
    struct _mulle_objc_propertylist                         *list;
@@ -141,7 +355,22 @@ struct _mulle_objc_property   *_mulle_objc_infraclass_search_property( struct _m
 
    if( ! infra->base.superclass)
       return( NULL);
-   return( _mulle_objc_infraclass_search_property( (struct _mulle_objc_infraclass *) infra->base.superclass, propertyid));
+   return( __mulle_objc_infraclass_search_property( (struct _mulle_objc_infraclass *) infra->base.superclass, propertyid));
+}
+
+
+struct _mulle_objc_property   *
+   _mulle_objc_infraclass_search_property( struct _mulle_objc_infraclass *infra,
+                                           mulle_objc_propertyid_t propertyid)
+{
+   struct _mulle_objc_infraclassindex   *index;
+
+   index = _mulle_objc_infraclass_get_index( infra,
+                                             &infra->propertyindex,
+                                             _mulle_objc_infraclass_build_propertyindex);
+   if( ! index)
+      return( __mulle_objc_infraclass_search_property( infra, propertyid));
+   return( _mulle_objc_cache_lookup_pointer( index->cache, propertyid));
 }
 
 
@@ -394,6 +623,7 @@ static int   _mulle_objc_infraclass_add_propertylist( struct _mulle_objc_infracl
    _mulle_objc_propertylistenumerator_done( &rover);
 
    _mulle_concurrent_pointerarray_add( &infra->propertylists, list);
+   _mulle_objc_infraclass_bump_indexgeneration( infra);
 
    return( 0);
 }
@@ -462,6 +692,7 @@ int   mulle_objc_infraclass_add_ivarlist( struct _mulle_objc_infraclass *infra,
    }
 
    _mulle_concurrent_pointerarray_add( &infra->ivarlists, list);
+   _mulle_objc_infraclass_bump_indexgeneration( infra);
    return( 0);
 }
 
@@ -483,8 +714,9 @@ void   mulle_objc_infraclass_add_ivarlist_nofail( struct _mulle_objc_infraclass
 //
 // doesn't check for duplicates
 //
-struct _mulle_objc_ivar   *_mulle_objc_infraclass_search_ivar( struct _mulle_objc_infraclass *infra,
-                                                               mulle_objc_ivarid_t ivarid)
+static struct _mulle_objc_ivar   *
+   __mulle_objc_infraclass_search_ivar( struct _mulle_objc_infraclass *infra,
+                                        mulle_objc_ivarid_t ivarid)
 {
    struct _mulle_objc_ivar                                 *ivar;
    struct _mulle_objc_ivarlist                             *list;
@@ -504,7 +736,21 @@ struct _mulle_objc_ivar   *_mulle_objc_infraclass_search_ivar( struct _mulle_obj
 
    if( ! infra->base.superclass)
       return( NULL);
-   return( _mulle_objc_infraclass_search_ivar( (struct _mulle_objc_infraclass *) infra->base.superclass, ivarid));
+   return( __mulle_objc_infraclass_search_ivar( (struct _mulle_objc_infraclass *) infra->base.superclass, ivarid));
+}
+
+
+struct _mulle_objc_ivar   *_mulle_objc_infraclass_search_ivar( struct _mulle_objc_infraclass *infra,
+                                                               mulle_objc_ivarid_t ivarid)
+{
+   struct _mulle_objc_infraclassindex   *index;
+
+   index = _mulle_objc_infraclass_get_index( infra,
+                                             &infra->ivarindex,
+                                             _mulle_objc_infraclass_build_ivarindex);
+   if( ! index)
+      return( __mulle_objc_infraclass_search_ivar( infra, ivarid));
+   return( _mulle_objc_cache_lookup_pointer( index->cache, ivarid));
 }
 
 
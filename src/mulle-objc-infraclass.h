@@ -76,10 +76,16 @@ struct _mulle_objc_infraclass
    mulle_objc_hash_t                         ivarhash;
    mulle_atomic_pointer_t                    taggedpointerindex;
    mulle_atomic_pointer_t                    coderversion; // for NSCoder
+   mulle_atomic_pointer_t                    lookupcount;  // MULLE_OBJC_COUNT_CLASS_LOOKUP
+   mulle_atomic_pointer_t                    allocstats;   // MULLE_OBJC_COUNT_INSTANCE_ALLOC
 
    struct mulle_concurrent_pointerarray      ivarlists;
    struct mulle_concurrent_pointerarray      propertylists;
 
+   // lazily built, see _mulle_objc_infraclass_search_ivar
+   mulle_atomic_pointer_t                    ivarindex;
+   mulle_atomic_pointer_t                    propertyindex;
+
 #if 0
    struct mulle_concurrent_hashmap           cvars;
 #endif
@@ -90,6 +96,46 @@ struct _mulle_objc_infraclass
 };
 
 
+//
+// An immutable uniqueid to ivar or property map, covering the infraclass
+// and all its superclasses. It's replaced as a whole, when the
+// indexgeneration of the universe changes.
+//
+struct _mulle_objc_infraclassindex
+{
+   uintptr_t                  generation;
+   struct _mulle_objc_cache   *cache;
+};
+
+// also used by the classpair for protocolids
+struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclassindex_new( uintptr_t generation,
+                                    unsigned int n,
+                                    struct _mulle_objc_universe *universe);
+
+void   _mulle_objc_infraclassindex_add( struct _mulle_objc_infraclassindex *index,
+                                       void *p,
+                                       mulle_objc_uniqueid_t uniqueid);
+
+void   _mulle_objc_infraclassindex_free( struct _mulle_objc_infraclassindex *index,
+                                        struct mulle_allocator *allocator);
+
+void   _mulle_objc_infraclassindex_abafree( struct _mulle_objc_infraclassindex *index,
+                                           struct mulle_allocator *allocator);
+
+//
+// returns the index at pointer, (re)building it with build if it's missing
+// or outdated. Returns NULL, if that didn't work out or if the current
+// thread isn't registered with the universe gc, then search the lists.
+// Also used by the classpair for protocolids.
+//
+struct _mulle_objc_infraclassindex   *
+   _mulle_objc_infraclass_get_index( struct _mulle_objc_infraclass *infra,
+                                     mulle_atomic_pointer_t *pointer,
+                                     struct _mulle_objc_infraclassindex *(*build)( struct _mulle_objc_infraclass *,
+                                                                                   uintptr_t));
+
+
 void   _mulle_objc_infraclass_plusinit( struct _mulle_objc_infraclass *infra,
                                         struct mulle_allocator *allocator);
 void   _mulle_objc_infraclass_plusdone( struct _mulle_objc_infraclass *infra);
@@ -462,6 +508,11 @@ int   mulle_objc_infraclass_add_propertylist( struct _mulle_objc_infraclass *inf
 void   mulle_objc_infraclass_add_propertylist_nofail( struct _mulle_objc_infraclass *infra,
                                                         struct _mulle_objc_propertylist *list);
 
+//
+// Uses an index like the ivar search. Rebuilding it abafrees the old one,
+// so only a thread registered with the universe gc uses the index, others
+// search the propertylists.
+//
 struct _mulle_objc_property   *
    _mulle_objc_infraclass_search_property( struct _mulle_objc_infraclass *infra,
                                            mulle_objc_propertyid_t propertyid);
@@ -482,6 +533,13 @@ void   mulle_objc_infraclass_add_ivarlist_nofail( struct _mulle_objc_infraclass
 
 # pragma mark - ivars
 
+//
+// These use an index, that is built on first use and rebuilt, when an
+// ivarlist is added to the class or a superclass. Rebuilding abafrees the
+// old index, so only a thread registered with the universe gc uses the
+// index. Otherwise or if the index can not be built, the ivarlists of the
+// class and its superclasses are searched.
+//
 struct _mulle_objc_ivar   *_mulle_objc_infraclass_search_ivar( struct _mulle_objc_infraclass *infra,
                                                                mulle_objc_ivarid_t ivarid);
 
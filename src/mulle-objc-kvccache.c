@@ -35,7 +35,9 @@
 //
 #include "mulle-objc-kvccache.h"
 
+#include "mulle-objc-call.h"
 #include "mulle-objc-class.h"
+#include "mulle-objc-retain-release.h"
 #include "mulle-objc-universe.h"
 #include "mulle-objc-signature.h"
 #include "mulle-objc-uniqueid.h"
@@ -53,29 +55,214 @@ struct _mulle_objc_kvcinfo  *_mulle_objc_kvcinfo_new( char *cKey,
    len   = strlen( cKey); // cKey is dimension [1], so no + 1 here
    entry = mulle_allocator_calloc( allocator, 1, len + sizeof( struct _mulle_objc_kvcinfo));
    memset( entry->valueType, _C_ID, 4);
+   entry->offset = MULLE_OBJC_KVCINFO_NO_IVAR;
    memcpy( entry->cKey, cKey, len);
+   entry->keyid = mulle_objc_uniqueid_from_string( cKey);
+   _mulle_objc_kvcinfo_init_ivaraccessors( entry);
    return( entry);
 }
 
 
+# pragma mark - ivar accessors
+
+#define KVC_IVAR_ACCESSORS( name, type)                       \
+static void   kvc_ivar_get_ ## name( void *ivar, void *value)  \
+{                                                              \
+   *(type *) value = *(type *) ivar;                           \
+}                                                              \
+                                                               \
+static void   kvc_ivar_take_ ## name( void *ivar, void *value) \
+{                                                              \
+   *(type *) ivar = *(type *) value;                           \
+}
+
+KVC_IVAR_ACCESSORS( char, char)
+KVC_IVAR_ACCESSORS( short, short)
+KVC_IVAR_ACCESSORS( int, int)
+KVC_IVAR_ACCESSORS( long, long)
+KVC_IVAR_ACCESSORS( longlong, long long)
+KVC_IVAR_ACCESSORS( float, float)
+KVC_IVAR_ACCESSORS( double, double)
+KVC_IVAR_ACCESSORS( longdouble, long double)
+KVC_IVAR_ACCESSORS( methodid, mulle_objc_methodid_t)
+KVC_IVAR_ACCESSORS( pointer, void *)
+
+#undef KVC_IVAR_ACCESSORS
+
+
+static void   kvc_ivar_take_retain_id( void *ivar, void *value)
+{
+   void   *old;
+
+   old             = *(void **) ivar;
+   *(void **) ivar = mulle_objc_object_retain( *(void **) value);
+   mulle_objc_object_release( old);
+}
+
+
+static void   kvc_ivar_take_copy_id( void *ivar, void *value)
+{
+   void   *old;
+   void   *obj;
+
+   obj = *(void **) value;
+   if( obj)
+      obj = mulle_objc_object_call( obj, MULLE_OBJC_COPY_METHODID, obj);
+
+   old             = *(void **) ivar;
+   *(void **) ivar = obj;
+   mulle_objc_object_release( old);
+}
+
+
+static mulle_objc_kvcivaraccessor_t   *
+   kvc_ivar_accessor_for_type( char type, int take)
+{
+   switch( type)
+   {
+   case _C_CHR      :
+   case _C_UCHR     :
+   case _C_BOOL     : return( take ? kvc_ivar_take_char : kvc_ivar_get_char);
+   case _C_SHT      :
+   case _C_USHT     : return( take ? kvc_ivar_take_short : kvc_ivar_get_short);
+   case _C_INT      :
+   case _C_UINT     : return( take ? kvc_ivar_take_int : kvc_ivar_get_int);
+   case _C_LNG      :
+   case _C_ULNG     : return( take ? kvc_ivar_take_long : kvc_ivar_get_long);
+   case _C_LNG_LNG  :
+   case _C_ULNG_LNG : return( take ? kvc_ivar_take_longlong : kvc_ivar_get_longlong);
+   case _C_FLT      : return( take ? kvc_ivar_take_float : kvc_ivar_get_float);
+   case _C_DBL      : return( take ? kvc_ivar_take_double : kvc_ivar_get_double);
+   case _C_LNG_DBL  : return( take ? kvc_ivar_take_longdouble : kvc_ivar_get_longdouble);
+   case _C_SEL      : return( take ? kvc_ivar_take_methodid : kvc_ivar_get_methodid);
+   case _C_CHARPTR  :
+   case _C_PTR      :
+   case _C_CLASS    :
+   case _C_ASSIGN_ID: return( take ? kvc_ivar_take_pointer : kvc_ivar_get_pointer);
+   case _C_RETAIN_ID: return( take ? kvc_ivar_take_retain_id : kvc_ivar_get_pointer);
+   case _C_COPY_ID  : return( take ? kvc_ivar_take_copy_id : kvc_ivar_get_pointer);
+   }
+   return( NULL);
+}
+
+
+void   _mulle_objc_kvcinfo_init_ivaraccessors( struct _mulle_objc_kvcinfo *info)
+{
+   // the default valueType _C_ID would otherwise hit the first ivar
+   if( info->offset == MULLE_OBJC_KVCINFO_NO_IVAR)
+   {
+      info->ivarget  = NULL;
+      info->ivartake = NULL;
+      return;
+   }
+
+   info->ivarget  = kvc_ivar_accessor_for_type( info->valueType[ MULLE_OBJC_KVCINFO_STOREDGET], 0);
+   info->ivartake = kvc_ivar_accessor_for_type( info->valueType[ MULLE_OBJC_KVCINFO_STOREDTAKE], 1);
+}
+
+
+# pragma mark - kvcinfo
+
+static struct _mulle_objc_kvcinfo *
+   _mulle_objc_kvcinfo_find_in_chain( struct _mulle_objc_kvcinfo *entry,
+                                      char *key)
+{
+   do
+   {
+      if( ! strcmp( entry->cKey, key))
+         return( entry);
+      entry = _mulle_objc_kvcinfo_get_next( entry);
+   }
+   while( entry);
+
+   return( NULL);
+}
+
+
+//
+// append info to the chain of infos sharing the same keyid, returns -1 if
+// the key is already present and 1 if the chain has been retired, because
+// its cache has been swapped out
+//
+static int   _mulle_objc_kvcinfo_chain( struct _mulle_objc_kvcinfo *entry,
+                                        struct _mulle_objc_kvcinfo *info)
+{
+   struct _mulle_objc_kvcinfo   *next;
+
+   assert( ! _mulle_objc_kvcinfo_get_next( info));
+
+   for(;;)
+   {
+      if( ! strcmp( entry->cKey, info->cKey))
+         return( -1);
+
+      next = _mulle_atomic_pointer_read( &entry->next);
+      if( ! next)
+      {
+         if( _mulle_atomic_pointer_cas( &entry->next, info, NULL))
+            return( 0);
+         next = _mulle_atomic_pointer_read( &entry->next);
+      }
+      if( next == MULLE_OBJC_KVCINFO_RETIRED)
+         return( 1);
+      entry = next;
+   }
+}
+
+
+//
+// free a chain and close its end, so that nothing can be appended to it
+// anymore, which would then leak
+//
+static void   _mulle_objc_kvcinfo_retire_chain( struct _mulle_objc_kvcinfo *info,
+                                                struct mulle_allocator *allocator)
+{
+   struct _mulle_objc_kvcinfo   *next;
+
+   for(;;)
+   {
+      next = _mulle_atomic_pointer_read( &info->next);
+      if( ! next)
+      {
+         if( ! _mulle_atomic_pointer_cas( &info->next, MULLE_OBJC_KVCINFO_RETIRED, NULL))
+            continue;
+         mulle_allocator_abafree( allocator, info);
+         return;
+      }
+      mulle_allocator_abafree( allocator, info);
+      info = next;
+   }
+}
+
+
 # pragma mark - cache
 
 static void  _mulle_objc_kvccache_abafree( struct _mulle_objc_kvccache *cache,
                                            struct mulle_allocator *allocator)
 {
    // walk through entries, free them. This can only be done
-   // if the cache entries have been successfully atomically exchanged
-   struct _mulle_objc_cacheentry      *start;
-   struct _mulle_objc_cacheentry      *sentinel;
-   struct _mulle_objc_kvccacheinfo    *info;
+   // if the cache entries have been successfully atomically exchanged.
+   // Other threads may still be adding to this cache, so each entry is
+   // taken by replacing it with MULLE_OBJC_KVCINFO_RETIRED. Empty entries
+   // stay empty, a late add there is taken back by the adder.
+   struct _mulle_objc_cacheentry   *start;
+   struct _mulle_objc_cacheentry   *sentinel;
+   struct _mulle_objc_kvcinfo      *info;
 
    start    = cache->base.entries;
    sentinel = &start[ cache->base.size];
-   while( start < sentinel)
+   for( ; start < sentinel; ++start)
    {
-      info = _mulle_atomic_pointer_read( &start->value.pointer);
-      mulle_allocator_abafree( allocator, info);
-      ++start;
+      do
+      {
+         info = _mulle_atomic_pointer_read( &start->value.pointer);
+         if( ! info || info == MULLE_OBJC_KVCINFO_RETIRED)
+            break;
+      }
+      while( ! _mulle_atomic_pointer_cas( &start->value.pointer, MULLE_OBJC_KVCINFO_RETIRED, info));
+
+      if( info && info != MULLE_OBJC_KVCINFO_RETIRED)
+         _mulle_objc_kvcinfo_retire_chain( info, allocator);
    }
 
    mulle_allocator_abafree( allocator, cache);
@@ -132,9 +319,16 @@ int    _mulle_objc_kvccachepivot_set_kvcinfo( struct _mulle_objc_kvccachepivot *
 {
    struct _mulle_objc_cacheentry      *entry;
    struct _mulle_objc_kvccache        *cache;
+   struct _mulle_objc_kvcinfo         *other;
    mulle_objc_uniqueid_t              keyid;
+   int                                rval;
+   int                                added;
+
+   keyid = _mulle_objc_kvcinfo_get_keyid( info);
+   assert( keyid == mulle_objc_uniqueid_from_string( info->cKey));
 
-   keyid = mulle_objc_uniqueid_from_string( info->cKey);
+   // offset and valueTypes are final now, info isn't visible to others yet
+   _mulle_objc_kvcinfo_init_ivaraccessors( info);
 
    for(;;)
    {
@@ -152,16 +346,45 @@ int    _mulle_objc_kvccachepivot_set_kvcinfo( struct _mulle_objc_kvccachepivot *
          continue;
       }
 
+      entry = _mulle_objc_kvccache_add_entry( cache, info, keyid, &added);
+      if( ! entry)
+         continue;  // slot taken by another keyid just now, try again
+
+      other = _mulle_atomic_pointer_read( &entry->value.pointer);
+      if( added)
+      {
+         //
+         // The cache may have been swapped out, while we were adding. If
+         // its entries were already walked for freeing, our info would leak.
+         // If we can take the info back, it's still ours and we retry with
+         // the current cache. Otherwise, also if the entry is RETIRED
+         // already, the info is owned and freed by the old cache.
+         //
+         if( other != info)
+            return( 0);
+         if( _mulle_objc_kvccachepivot_atomicget_cache( pivot) == cache)
+            return( 0);
+         if( _mulle_atomic_pointer_cas( &entry->value.pointer, MULLE_OBJC_KVCINFO_RETIRED, info))
+            continue;
+         return( 0);
+      }
+
+      // someone else's entry was taken by a retiring cache, retry with the
+      // current cache
+      if( other == MULLE_OBJC_KVCINFO_RETIRED)
+         continue;
+
       //
-      // when we have a conflict, there are two possibilties
-      // recreate the cache and use the new value
-      // bail: I think bailing is better, because we can't get into thrashing
-      // when two keys match and are used often
+      // if the entry isn't ours, it's an info with the same keyid, which is
+      // either the same key or a hash collision. Collisions are chained, so
+      // that two keys that are used often don't thrash the cache. A chain
+      // of a retired cache is closed, so then we retry with the current
+      // cache.
       //
-      entry = _mulle_objc_kvccache_add_entry( cache, info, keyid);
-      if( entry)
-         return( 0);
-      return( -1);  // conflict
+      rval = _mulle_objc_kvcinfo_chain( other, info);
+      if( rval == 1)
+         continue;
+      return( rval);
    }
 }
 
@@ -170,20 +393,30 @@ int    _mulle_objc_kvccachepivot_set_kvcinfo( struct _mulle_objc_kvccachepivot *
 // the kvcinfo will be for this keyid, but there could be duplicates
 //
 struct _mulle_objc_kvcinfo  *
-   _mulle_objc_kvccache_lookup_kvcinfo( struct _mulle_objc_kvccache *cache,
-                                        char *key)
+   _mulle_objc_kvccache_lookup_kvcinfo_keyid( struct _mulle_objc_kvccache *cache,
+                                              char *key,
+                                              mulle_objc_uniqueid_t keyid)
 {
-   mulle_objc_uniqueid_t           keyid;
    struct _mulle_objc_kvcinfo      *info;
 
-   keyid = mulle_objc_uniqueid_from_string( key);
-   info  = _mulle_objc_cache_lookup_pointer(  (struct _mulle_objc_cache *) cache, keyid);
-   if( ! info)
+   assert( keyid == mulle_objc_uniqueid_from_string( key));
+
+   info = _mulle_objc_cache_lookup_pointer(  (struct _mulle_objc_cache *) cache, keyid);
+   if( ! info || info == MULLE_OBJC_KVCINFO_RETIRED)
       return( NULL);
 
-   if( strcmp( info->cKey, key))
-      return( MULLE_OBJC_KVCINFO_CONFLICT);
-   return( info);
+   return( _mulle_objc_kvcinfo_find_in_chain( info, key));
+}
+
+
+struct _mulle_objc_kvcinfo  *
+   _mulle_objc_kvccache_lookup_kvcinfo( struct _mulle_objc_kvccache *cache,
+                                        char *key)
+{
+   mulle_objc_uniqueid_t   keyid;
+
+   keyid = mulle_objc_uniqueid_from_string( key);
+   return( _mulle_objc_kvccache_lookup_kvcinfo_keyid( cache, key, keyid));
 }
 
 
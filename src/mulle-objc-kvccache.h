@@ -51,13 +51,39 @@
 // Valuetype can be different for get/stored if ivar is
 // declared as short, and method is declared as int
 //
+// The keyid is the hash of cKey, computed once in _mulle_objc_kvcinfo_new.
+// Infos with the same keyid but different keys are chained via next.
+//
+// ivarget and ivartake are type specialized loads/stores for the ivar at
+// offset, chosen by _mulle_objc_kvcinfo_init_ivaraccessors from the
+// stored valueTypes. value points to storage of that type.
+//
+typedef void   mulle_objc_kvcivaraccessor_t( void *ivar, void *value);
+
 struct _mulle_objc_kvcinfo
 {
-   mulle_objc_implementation_t   implementation[ 4];
-   mulle_objc_methodid_t         methodid[ 4];
-   ptrdiff_t                     offset;
-   char                          valueType[ 4];
-   char                          cKey[ 1];  // flexible
+   mulle_objc_implementation_t    implementation[ 4];
+   mulle_objc_methodid_t          methodid[ 4];
+   mulle_objc_kvcivaraccessor_t   *ivarget;
+   mulle_objc_kvcivaraccessor_t   *ivartake;
+   ptrdiff_t                      offset;
+   mulle_objc_uniqueid_t          keyid;
+   mulle_atomic_pointer_t         next;
+   char                           valueType[ 4];
+   char                           cKey[ 1];  // flexible
+};
+
+
+// offset of an info, whose key has no ivar (0 is a valid ivar offset)
+#define MULLE_OBJC_KVCINFO_NO_IVAR   ((ptrdiff_t) -1)
+
+
+enum mulle_objc_kvcinfo_index
+{
+   MULLE_OBJC_KVCINFO_GET        = 0,
+   MULLE_OBJC_KVCINFO_TAKE       = 1,
+   MULLE_OBJC_KVCINFO_STOREDGET  = 2,
+   MULLE_OBJC_KVCINFO_STOREDTAKE = 3
 };
 
 
@@ -74,7 +100,66 @@ static inline void  _mulle_objc_kvcinfo_free( struct _mulle_objc_kvcinfo *entry,
 static inline int  _mulle_objc_kvcinfo_equals( struct _mulle_objc_kvcinfo *entry,
                                                struct _mulle_objc_kvcinfo *other)
 {
-   return( ! strcmp( entry->cKey, other->cKey));
+   return( entry->keyid == other->keyid && ! strcmp( entry->cKey, other->cKey));
+}
+
+
+//
+// Called by _mulle_objc_kvcinfo_new and again when the info is set into a
+// kvc cache, so offset and stored valueTypes filled in before that are
+// picked up. Call it yourself, if you change them later. The accessors
+// remain NULL, if offset is MULLE_OBJC_KVCINFO_NO_IVAR (the default of a
+// new info) or if the type isn't supported. Retaining and copying setters
+// release the previous value.
+//
+void   _mulle_objc_kvcinfo_init_ivaraccessors( struct _mulle_objc_kvcinfo *info);
+
+
+// returns -1 if there is no ivar accessor
+static inline int   _mulle_objc_kvcinfo_get_ivarvalue( struct _mulle_objc_kvcinfo *entry,
+                                                       void *obj,
+                                                       void *value)
+{
+   if( ! entry->ivarget)
+      return( -1);
+   (*entry->ivarget)( &((char *) obj)[ entry->offset], value);
+   return( 0);
+}
+
+
+static inline int   _mulle_objc_kvcinfo_take_ivarvalue( struct _mulle_objc_kvcinfo *entry,
+                                                        void *obj,
+                                                        void *value)
+{
+   if( ! entry->ivartake)
+      return( -1);
+   (*entry->ivartake)( &((char *) obj)[ entry->offset], value);
+   return( 0);
+}
+
+
+static inline mulle_objc_uniqueid_t
+   _mulle_objc_kvcinfo_get_keyid( struct _mulle_objc_kvcinfo *entry)
+{
+   return( entry->keyid);
+}
+
+
+//
+// A retired kvc cache has its entries and the ends of its chains set to
+// MULLE_OBJC_KVCINFO_RETIRED, so that no info can be added to it anymore
+// after it has been walked for freeing.
+//
+#define MULLE_OBJC_KVCINFO_RETIRED    ((struct _mulle_objc_kvcinfo *) -2)
+
+
+static inline struct _mulle_objc_kvcinfo *
+   _mulle_objc_kvcinfo_get_next( struct _mulle_objc_kvcinfo *entry)
+{
+   struct _mulle_objc_kvcinfo   *next;
+
+   next = _mulle_atomic_pointer_read( &entry->next);
+   return( next == MULLE_OBJC_KVCINFO_RETIRED ? NULL : next);
 }
 
 
@@ -85,6 +170,7 @@ struct _mulle_objc_kvccache
    struct _mulle_objc_cache    base;
 };
 
+// no longer returned by the lookup, as conflicting keys are chained now
 #define MULLE_OBJC_KVCINFO_CONFLICT   ((struct _mulle_objc_kvcinfo *) -1)
 
 
@@ -97,12 +183,14 @@ static inline struct _mulle_objc_kvccache  *
 
 
 
+// *p_added is 1, if info was installed by this call
 static inline struct _mulle_objc_cacheentry  *
    _mulle_objc_kvccache_add_entry( struct _mulle_objc_kvccache *cache,
                                    struct _mulle_objc_kvcinfo *info,
-                                   mulle_objc_uniqueid_t keyid)
+                                   mulle_objc_uniqueid_t keyid,
+                                   int *p_added)
 {
-   return( _mulle_objc_cache_add_pointer_entry( (struct _mulle_objc_cache *) cache, info, keyid));
+   return( __mulle_objc_cache_add_pointer_entry( (struct _mulle_objc_cache *) cache, info, keyid, p_added));
 }
 
 
@@ -115,6 +203,15 @@ static inline struct _mulle_objc_cacheentry  *
 }
 
 
+//
+// Use the keyid variant, if you have hashed the key already. keyid must be
+// mulle_objc_uniqueid_from_string( key).
+//
+struct _mulle_objc_kvcinfo  *
+   _mulle_objc_kvccache_lookup_kvcinfo_keyid( struct _mulle_objc_kvccache *cache,
+                                              char *key,
+                                              mulle_objc_uniqueid_t keyid);
+
 struct _mulle_objc_kvcinfo  *_mulle_objc_kvccache_lookup_kvcinfo( struct _mulle_objc_kvccache *cache,
                                                                  char *key);
 
@@ -156,6 +253,11 @@ int   _mulle_objc_kvccachepivot_invalidate( struct _mulle_objc_kvccachepivot *pi
 
 
 
+//
+// returns -1, if info wasn't stored, because it is already present or
+// memory ran out. The caller still owns info then. The ivar accessors of
+// info are (re)initialized.
+//
 int    _mulle_objc_kvccachepivot_set_kvcinfo( struct _mulle_objc_kvccachepivot *pivot,
                                              struct _mulle_objc_kvcinfo *info,
                                              struct _mulle_objc_kvccache *empty_cache,
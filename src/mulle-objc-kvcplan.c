@@ -0,0 +1,223 @@
+//
+//  mulle-objc-kvcplan.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-kvcplan.h"
+
+#include "mulle-objc-class.h"
+#include "mulle-objc-universe.h"
+#include "mulle-objc-uniqueid.h"
+
+#include "include-private.h"
+#include <errno.h>
+#include <string.h>
+
+
+static void   _mulle_objc_kvcstep_init( struct _mulle_objc_kvcstep *step,
+                                        struct _mulle_objc_kvcinfo *info)
+{
+   memcpy( step->implementation, info->implementation, sizeof( step->implementation));
+   memcpy( step->methodid, info->methodid, sizeof( step->methodid));
+   memcpy( step->valueType, info->valueType, sizeof( step->valueType));
+   step->ivarget  = info->ivarget;
+   step->ivartake = info->ivartake;
+   step->offset   = info->offset;
+}
+
+
+static int   _mulle_objc_class_resolve_kvcstep( struct _mulle_objc_class *cls,
+                                                char *key,
+                                                mulle_objc_kvcinfo_resolver_t *resolver,
+                                                void *userinfo,
+                                                struct _mulle_objc_kvcstep *step)
+{
+   struct _mulle_objc_kvcinfo   *info;
+   mulle_objc_uniqueid_t        keyid;
+
+   keyid = mulle_objc_uniqueid_from_string( key);
+   info  = _mulle_objc_class_lookup_kvcinfo_keyid( cls, key, keyid);
+   if( info)
+   {
+      _mulle_objc_kvcstep_init( step, info);
+      return( 0);
+   }
+
+   if( ! resolver)
+      return( -1);
+
+   info = (*resolver)( cls, key, userinfo);
+   if( ! info)
+      return( -1);
+
+   // offset and valueTypes are final now, the step copies the accessors
+   _mulle_objc_kvcinfo_init_ivaraccessors( info);
+   _mulle_objc_kvcstep_init( step, info);
+   if( _mulle_objc_class_set_kvcinfo( cls, info))
+      _mulle_objc_kvcinfo_free( info, _mulle_objc_class_get_kvcinfo_allocator( cls));
+   return( 0);
+}
+
+
+struct _mulle_objc_kvcplan   *
+   mulle_objc_kvcplan_new( struct _mulle_objc_class *cls,
+                           char **keys,
+                           unsigned int n,
+                           mulle_objc_kvcinfo_resolver_t *resolver,
+                           void *userinfo)
+{
+   struct _mulle_objc_kvcplan   *plan;
+   struct _mulle_objc_kvcstep   *step;
+   struct mulle_allocator       *allocator;
+   unsigned int                 i;
+   unsigned int                 j;
+
+   if( ! cls || (n && ! keys))
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   allocator = _mulle_objc_class_get_kvcinfo_allocator( cls);
+   plan      = mulle_allocator_calloc( allocator,
+                                       1,
+                                       sizeof( struct _mulle_objc_kvcplan) +
+                                       sizeof( struct _mulle_objc_kvcstep) * (n ? n - 1 : 0));
+   plan->cls       = cls;
+   plan->allocator = allocator;
+
+   for( i = 0; i < n; i++)
+   {
+      step = &plan->steps[ i];
+      if( _mulle_objc_class_resolve_kvcstep( cls, keys[ i], resolver, userinfo, step))
+      {
+         mulle_objc_kvcplan_free( plan);
+         errno = ENOENT;
+         return( NULL);
+      }
+
+      plan->n++;
+      for( j = 0; j < 4; j++)
+         if( step->implementation[ j])
+            plan->n_implementations[ j]++;
+      if( step->ivarget)
+         plan->n_ivaraccessors[ 0]++;
+      if( step->ivartake)
+         plan->n_ivaraccessors[ 1]++;
+   }
+
+   return( plan);
+}
+
+
+void   mulle_objc_kvcplan_free( struct _mulle_objc_kvcplan *plan)
+{
+   if( ! plan)
+      return;
+
+   mulle_allocator_free( plan->allocator, plan);
+}
+
+
+int   _mulle_objc_kvcplan_get_values( struct _mulle_objc_kvcplan *plan,
+                                      void *obj,
+                                      enum mulle_objc_kvcinfo_index index,
+                                      void **values)
+{
+   struct _mulle_objc_kvcstep   *p;
+   struct _mulle_objc_kvcstep   *sentinel;
+
+   if( ! _mulle_objc_kvcplan_has_all_implementations( plan, index))
+      return( -1);
+
+   p        = plan->steps;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; ++p)
+      *values++ = (*p->implementation[ index])( obj, p->methodid[ index], obj);
+   return( 0);
+}
+
+
+int   _mulle_objc_kvcplan_take_values( struct _mulle_objc_kvcplan *plan,
+                                       void *obj,
+                                       enum mulle_objc_kvcinfo_index index,
+                                       void **values)
+{
+   struct _mulle_objc_kvcstep   *p;
+   struct _mulle_objc_kvcstep   *sentinel;
+
+   if( ! _mulle_objc_kvcplan_has_all_implementations( plan, index))
+      return( -1);
+
+   p        = plan->steps;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; ++p)
+      (*p->implementation[ index])( obj, p->methodid[ index], *values++);
+   return( 0);
+}
+
+
+int   _mulle_objc_kvcplan_get_ivarvalues( struct _mulle_objc_kvcplan *plan,
+                                          void *obj,
+                                          void **values)
+{
+   struct _mulle_objc_kvcstep   *p;
+   struct _mulle_objc_kvcstep   *sentinel;
+
+   if( ! _mulle_objc_kvcplan_has_all_ivaraccessors( plan, 0))
+      return( -1);
+
+   p        = plan->steps;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; ++p)
+      (*p->ivarget)( &((char *) obj)[ p->offset], *values++);
+   return( 0);
+}
+
+
+int   _mulle_objc_kvcplan_take_ivarvalues( struct _mulle_objc_kvcplan *plan,
+                                           void *obj,
+                                           void **values)
+{
+   struct _mulle_objc_kvcstep   *p;
+   struct _mulle_objc_kvcstep   *sentinel;
+
+   if( ! _mulle_objc_kvcplan_has_all_ivaraccessors( plan, 1))
+      return( -1);
+
+   p        = plan->steps;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; ++p)
+      (*p->ivartake)( &((char *) obj)[ p->offset], *values++);
+   return( 0);
+}
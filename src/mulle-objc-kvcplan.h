@@ -0,0 +1,176 @@
+//
+//  mulle-objc-kvcplan.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_kvcplan_h__
+#define mulle_objc_kvcplan_h__
+
+#include "mulle-objc-kvccache.h"
+
+#include "include.h"
+
+
+struct _mulle_objc_class;
+
+//
+// A kvcplan is a precompiled list of steps for a fixed list of keys of
+// a class. It's used to read or write the same keys of many objects,
+// without doing a kvc cache lookup for each key. Each step holds what was
+// resolved for its key: the implementations and methodids, or the ivar
+// offset with its accessors and the valueTypes. The steps are stored
+// inline in the plan, so it's not affected by kvc cache invalidation. But
+// it will be outdated, if the class changes (e.g. a category is added), so
+// plans should be created after loading is done.
+//
+struct _mulle_objc_kvcstep
+{
+   mulle_objc_implementation_t    implementation[ 4];  // see mulle_objc_kvcinfo_index
+   mulle_objc_methodid_t          methodid[ 4];
+   mulle_objc_kvcivaraccessor_t   *ivarget;
+   mulle_objc_kvcivaraccessor_t   *ivartake;
+   ptrdiff_t                      offset;
+   char                           valueType[ 4];
+};
+
+
+struct _mulle_objc_kvcplan
+{
+   struct _mulle_objc_class     *cls;
+   struct mulle_allocator       *allocator;
+   unsigned int                 n;
+   unsigned int                 n_implementations[ 4]; // see mulle_objc_kvcinfo_index
+   unsigned int                 n_ivaraccessors[ 2];   // get, take
+   struct _mulle_objc_kvcstep   steps[ 1];             // flexible
+};
+
+
+//
+// The resolver is called for keys, that are not in the kvc cache of the
+// class yet. It returns a new kvcinfo, that will be placed into the kvc
+// cache, or NULL if the key is unknown.
+//
+typedef struct _mulle_objc_kvcinfo  *
+   mulle_objc_kvcinfo_resolver_t( struct _mulle_objc_class *cls,
+                                  char *key,
+                                  void *userinfo);
+
+
+# pragma mark - create/free
+
+struct _mulle_objc_kvcplan   *
+   mulle_objc_kvcplan_new( struct _mulle_objc_class *cls,
+                           char **keys,
+                           unsigned int n,
+                           mulle_objc_kvcinfo_resolver_t *resolver,
+                           void *userinfo);
+
+void   mulle_objc_kvcplan_free( struct _mulle_objc_kvcplan *plan);
+
+
+# pragma mark - petty accessors
+
+static inline unsigned int
+   _mulle_objc_kvcplan_get_count( struct _mulle_objc_kvcplan *plan)
+{
+   return( plan->n);
+}
+
+
+static inline struct _mulle_objc_class *
+   _mulle_objc_kvcplan_get_class( struct _mulle_objc_kvcplan *plan)
+{
+   return( plan->cls);
+}
+
+
+static inline struct _mulle_objc_kvcstep *
+   _mulle_objc_kvcplan_get_step( struct _mulle_objc_kvcplan *plan,
+                                 unsigned int i)
+{
+   assert( i < plan->n);
+   return( &plan->steps[ i]);
+}
+
+
+// can all keys be handled with the implementations at "index" ?
+static inline int
+   _mulle_objc_kvcplan_has_all_implementations( struct _mulle_objc_kvcplan *plan,
+                                                enum mulle_objc_kvcinfo_index index)
+{
+   return( plan->n_implementations[ index] == plan->n);
+}
+
+
+// can all keys be handled with the ivar accessors ?
+static inline int
+   _mulle_objc_kvcplan_has_all_ivaraccessors( struct _mulle_objc_kvcplan *plan,
+                                              int take)
+{
+   return( plan->n_ivaraccessors[ take ? 1 : 0] == plan->n);
+}
+
+
+# pragma mark - execution
+
+//
+// These call the implementations of index for all keys in one loop. They
+// return -1 and do nothing, if not all keys have an implementation for
+// index. Then the caller has to fall back to per step code, which may
+// use the ivar offset and valueType of the step (e.g. for boxing).
+//
+// values must have space for n values
+int   _mulle_objc_kvcplan_get_values( struct _mulle_objc_kvcplan *plan,
+                                      void *obj,
+                                      enum mulle_objc_kvcinfo_index index,
+                                      void **values);
+
+int   _mulle_objc_kvcplan_take_values( struct _mulle_objc_kvcplan *plan,
+                                       void *obj,
+                                       enum mulle_objc_kvcinfo_index index,
+                                       void **values);
+
+//
+// These use the ivar accessors of all keys in one loop. values[ i] points
+// to storage of the stored valueType of key i. They return -1 and do
+// nothing, if not all keys have an ivar accessor.
+//
+int   _mulle_objc_kvcplan_get_ivarvalues( struct _mulle_objc_kvcplan *plan,
+                                          void *obj,
+                                          void **values);
+
+int   _mulle_objc_kvcplan_take_ivarvalues( struct _mulle_objc_kvcplan *plan,
+                                           void *obj,
+                                           void **values);
+
+#endif
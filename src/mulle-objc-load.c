@@ -46,6 +46,7 @@
 #include "mulle-objc-loadinfo.h"
 #include "mulle-objc-metaclass.h"
 #include "mulle-objc-methodlist.h"
+#include "mulle-objc-probe.h"
 #include "mulle-objc-propertylist.h"
 #include "mulle-objc-protocollist.h"
 #include "mulle-objc-universe.h"
@@ -572,6 +573,11 @@ static mulle_objc_classid_t   _mulle_objc_loadclass_enqueue( struct _mulle_objc_
       }
    }
 
+   MULLE_OBJC_PROBE3( class__load,
+                      infra,
+                      _mulle_objc_infraclass_get_classid( infra),
+                      _mulle_objc_infraclass_get_name( infra));
+
    //
    // check if categories or classes are waiting for us ?
    //
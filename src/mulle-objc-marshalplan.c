@@ -0,0 +1,143 @@
+//
+//  mulle-objc-marshalplan.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-marshalplan.h"
+
+#include "include-private.h"
+#include <errno.h>
+
+
+static void
+   _mulle_objc_marshalplan_add_run( struct _mulle_objc_marshalplan *plan,
+                                    uint32_t offset,
+                                    uint32_t size)
+{
+   struct _mulle_objc_copyrun   *prev;
+   struct _mulle_objc_copyrun   *run;
+
+   // merge with previous run, if there is no padding inbetween
+   if( plan->n)
+   {
+      prev = &plan->runs[ plan->n - 1];
+      if( prev->offset + prev->size == offset)
+      {
+         prev->size       += size;
+         plan->packedsize += size;
+         return;
+      }
+   }
+
+   run                = &plan->runs[ plan->n++];
+   run->offset        = offset;
+   run->packed_offset = (uint32_t) plan->packedsize;
+   run->size          = size;
+   plan->packedsize  += size;
+}
+
+
+struct _mulle_objc_marshalplan   *
+   mulle_objc_marshalplan_new( struct _mulle_objc_signatureinfo *info,
+                               struct mulle_allocator *allocator)
+{
+   struct _mulle_objc_marshalplan   *plan;
+   struct mulle_objc_typeinfo       *p;
+   struct mulle_objc_typeinfo       *sentinel;
+   unsigned int                     n;
+   int32_t                          base;
+
+   if( ! info)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   if( info->paramtype == mulle_metaabi_param_error)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   if( ! allocator)
+      allocator = &mulle_default_allocator;
+
+   // rval + self + _cmd, the rest are the arguments in the _param block
+   n    = info->n > 3 ? info->n - 3 : 0;
+   plan = mulle_allocator_calloc( allocator,
+                                  1,
+                                  sizeof( struct _mulle_objc_marshalplan) +
+                                  sizeof( struct _mulle_objc_copyrun) * (n ? n - 1 : 0));
+
+   plan->signatureinfo = info;
+   plan->allocator     = allocator;
+   plan->rvalsize      = info->typeinfos[ 0].natural_size;
+
+   if( ! n)
+      return( plan);
+
+   p        = &info->typeinfos[ 3];
+   sentinel = &info->typeinfos[ info->n];
+
+   switch( info->paramtype)
+   {
+   case mulle_metaabi_param_void_pointer :
+      plan->has_object = p->has_object;
+      _mulle_objc_marshalplan_add_run( plan, 0, sizeof( void *));
+      break;
+
+   case mulle_metaabi_param_struct :
+      base = p->invocation_offset;
+      for( ; p < sentinel; p++)
+      {
+         plan->has_object |= p->has_object;
+         _mulle_objc_marshalplan_add_run( plan,
+                                          (uint32_t) (p->invocation_offset - base),
+                                          p->natural_size);
+      }
+      break;
+
+   default :
+      break;
+   }
+   return( plan);
+}
+
+
+void   mulle_objc_marshalplan_free( struct _mulle_objc_marshalplan *plan)
+{
+   if( ! plan)
+      return;
+
+   mulle_allocator_free( plan->allocator, plan);
+}
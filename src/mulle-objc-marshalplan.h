@@ -0,0 +1,153 @@
+//
+//  mulle-objc-marshalplan.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_marshalplan_h__
+#define mulle_objc_marshalplan_h__
+
+#include "mulle-objc-signatureinfo.h"
+
+#include "include.h"
+
+
+//
+// A marshalplan copies the arguments of a metaABI _param block to and from
+// a packed buffer, where the arguments follow each other without padding.
+// Arguments that are adjacent in the _param block are merged into a single
+// run, so packing is a few memcpys and no type switches.
+//
+// For mulle_metaabi_param_void_pointer the "block" is the _param pointer
+// itself, so pass its address. The plan copies all of its sizeof( void *)
+// bytes. For mulle_metaabi_param_void there is nothing to copy.
+//
+// Objects are copied as pointers, retaining them is up to the caller
+// (see has_object). Variadic arguments are not covered.
+//
+struct _mulle_objc_copyrun
+{
+   uint32_t   offset;         // in _param block
+   uint32_t   packed_offset;  // in packed buffer
+   uint32_t   size;
+};
+
+
+struct _mulle_objc_marshalplan
+{
+   struct _mulle_objc_signatureinfo   *signatureinfo;
+   struct mulle_allocator             *allocator;
+   size_t                             packedsize;  // of all arguments
+   size_t                             rvalsize;    // rval is at offset 0 of the _param block
+   int                                has_object;  // some argument contains an object
+   unsigned int                       n;
+   struct _mulle_objc_copyrun         runs[ 1];    // flexible
+};
+
+
+# pragma mark - create/free
+
+//
+// returns NULL and sets errno to EINVAL, if the signature can not be
+// marshalled (mulle_metaabi_param_error)
+//
+struct _mulle_objc_marshalplan   *
+   mulle_objc_marshalplan_new( struct _mulle_objc_signatureinfo *info,
+                               struct mulle_allocator *allocator);
+
+void   mulle_objc_marshalplan_free( struct _mulle_objc_marshalplan *plan);
+
+
+# pragma mark - petty accessors
+
+static inline size_t
+   _mulle_objc_marshalplan_get_packedsize( struct _mulle_objc_marshalplan *plan)
+{
+   return( plan->packedsize);
+}
+
+
+static inline size_t
+   _mulle_objc_marshalplan_get_rvalsize( struct _mulle_objc_marshalplan *plan)
+{
+   return( plan->rvalsize);
+}
+
+
+static inline unsigned int
+   _mulle_objc_marshalplan_get_runcount( struct _mulle_objc_marshalplan *plan)
+{
+   return( plan->n);
+}
+
+
+static inline int
+   _mulle_objc_marshalplan_has_object( struct _mulle_objc_marshalplan *plan)
+{
+   return( plan->has_object);
+}
+
+
+# pragma mark - execution
+
+// buf must have space for packedsize bytes
+static inline void
+   _mulle_objc_marshalplan_pack( struct _mulle_objc_marshalplan *plan,
+                                 void *param,
+                                 void *buf)
+{
+   struct _mulle_objc_copyrun   *p;
+   struct _mulle_objc_copyrun   *sentinel;
+
+   p        = plan->runs;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; p++)
+      memcpy( &((char *) buf)[ p->packed_offset], &((char *) param)[ p->offset], p->size);
+}
+
+
+// param must be at least _mulle_objc_signatureinfo_get_metaabisize bytes
+static inline void
+   _mulle_objc_marshalplan_unpack( struct _mulle_objc_marshalplan *plan,
+                                   void *buf,
+                                   void *param)
+{
+   struct _mulle_objc_copyrun   *p;
+   struct _mulle_objc_copyrun   *sentinel;
+
+   p        = plan->runs;
+   sentinel = &p[ plan->n];
+   for( ; p < sentinel; p++)
+      memcpy( &((char *) param)[ p->offset], &((char *) buf)[ p->packed_offset], p->size);
+}
+
+#endif
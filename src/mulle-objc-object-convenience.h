@@ -109,6 +109,16 @@ MULLE_C_NONNULL_RETURN static inline struct mulle_allocator   *
 
 static inline void  __mulle_objc_instance_will_free( struct _mulle_objc_object *obj)
 {
+#ifdef MULLE_OBJC_ALLOCSTATS
+   {
+      struct _mulle_objc_class   *cls;
+
+      cls = _mulle_objc_object_get_isa( obj);
+      if( _mulle_atomic_pointer_read( &_mulle_objc_class_get_universe( cls)->debug.count.instance_alloc))
+         _mulle_objc_infraclass_count_free( _mulle_objc_class_as_infraclass( cls));
+   }
+#endif
+
 // too slow for non debug
 #if DEBUG
    {
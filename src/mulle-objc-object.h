@@ -46,6 +46,7 @@
 #include "mulle-objc-taggedpointer.h"
 
 #include <assert.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -56,6 +57,15 @@ struct _mulle_objc_method;
 # define MULLE_OBJC_CALL_PREFER_TPS  1
 #endif
 
+//
+// With tagged pointers, resolve the isa with a masked address select instead
+// of a branch. This keeps the inlined call sequence shorter. It is off by
+// default, measure your code with it before switching.
+//
+#ifndef MULLE_OBJC_CALL_BRANCHFREE_ISA
+# define MULLE_OBJC_CALL_BRANCHFREE_ISA  0
+#endif
+
 //
 // an object can be both a instance or a _class, so it should be typed as
 // void *. Possibly should renamed struct _mulle_objc_object to
@@ -98,6 +108,39 @@ static inline struct _mulle_objc_class   *_mulle_objc_object_const_get_isa( void
 }
 
 
+//
+// The universe keeps the isas of the tagged pointer classes in a table
+// indexed by the tagged pointer index. Index 0 is a regular object, for
+// which the isa address is in the objectheader instead. Either way there
+// is just one load from an address selected with a mask, as compilers turn
+// a ternary back into a branch. The default universe is a global, so the
+// table address is a constant.
+//
+MULLE_C_ALWAYS_INLINE_NONNULL_RETURN
+static inline struct _mulle_objc_class *
+   _mulle_objc_object_get_isa_branchfree( void *obj)
+{
+   unsigned int                  index;
+   struct _mulle_objc_universe   *universe;
+   struct _mulle_objc_class      **p_isa;
+   uintptr_t                     header_isa;
+   uintptr_t                     table_isa;
+   uintptr_t                     mask;
+
+   index    = mulle_objc_object_get_taggedpointerindex( obj);
+   universe = mulle_objc_global_get_universe_inline( MULLE_OBJC_DEFAULTUNIVERSEID);
+
+   // don't use _mulle_objc_object_get_objectheader, obj may be tagged
+   header_isa = (uintptr_t) obj - sizeof( struct _mulle_objc_objectheader)
+                + offsetof( struct _mulle_objc_objectheader, _isa);
+   table_isa  = (uintptr_t) &universe->taggedpointers.pointerisa[ index];
+   mask       = (uintptr_t) 0 - (index != 0);
+   p_isa      = (struct _mulle_objc_class **) (header_isa ^ ((header_isa ^ table_isa) & mask));
+   assert( *p_isa && "Tagged pointer class not configured. Is your object properly initialized ?");
+   return( *p_isa);
+}
+
+
 //
 // don't use isa in most cases, use get_class (defined elsewhere)
 //
@@ -109,6 +152,10 @@ static inline struct _mulle_objc_class *
    struct _mulle_objc_universe     *universe;
    struct _mulle_objc_infraclass   *infra;
 
+#if defined( __MULLE_OBJC_TPS__) && MULLE_OBJC_CALL_BRANCHFREE_ISA
+   return( _mulle_objc_object_get_isa_branchfree( obj));
+#endif
+
    // compiler should notice that #ifdef __MULLE_OBJC_NO_TPS__ index is always 0
    index = mulle_objc_object_get_taggedpointerindex( obj);
    if( __builtin_expect( ! index, MULLE_OBJC_CALL_PREFER_TPS)) // prefer tagged pointers path
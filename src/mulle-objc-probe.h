@@ -0,0 +1,93 @@
+//
+//  mulle-objc-probe.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+#ifndef mulle_objc_probe_h__
+#define mulle_objc_probe_h__
+
+//
+// Static probe points (USDT) for perf, bpftrace, systemtap or dtrace. They
+// are only compiled in, if MULLE_OBJC_PROBES is defined (cmake option
+// MULLE_OBJC_PROBES). This needs <sys/sdt.h>, which is header only, there is
+// nothing to link against. An unattached probe is a single nop.
+//
+// The provider is "mulle_objc". dtrace shows a double underscore in the
+// probe name as a dash, perf and bpftrace use the name as is. List them with:
+//
+//    bpftrace -l 'usdt:libmulle-objc-runtime.so:*'
+//
+// Probe                   | Arguments
+// ------------------------|------------------------------------------
+// methodcache__swap       | cls, classid, old cache, new cache, methodid
+// supercache__swap        | cls, classid, old cache, new cache, superid
+// method__search__miss    | cls, classid, methodid
+// initialize__start       | infraclass, classid
+// initialize__done        | infraclass, classid
+// class__load             | infraclass, classid, name
+// descriptor__add         | descriptor, methodid, name
+// object__finalize        | obj
+// object__dealloc         | obj
+// universe__crunch__start | universe
+// universe__crunch__done  | universe
+//
+// This header is private, it must only be included by .c files.
+//
+#ifdef MULLE_OBJC_PROBES
+
+# include <sys/sdt.h>
+
+# define MULLE_OBJC_PROBE( name)                  \
+   DTRACE_PROBE( mulle_objc, name)
+# define MULLE_OBJC_PROBE1( name, a)              \
+   DTRACE_PROBE1( mulle_objc, name, a)
+# define MULLE_OBJC_PROBE2( name, a, b)           \
+   DTRACE_PROBE2( mulle_objc, name, a, b)
+# define MULLE_OBJC_PROBE3( name, a, b, c)        \
+   DTRACE_PROBE3( mulle_objc, name, a, b, c)
+# define MULLE_OBJC_PROBE4( name, a, b, c, d)     \
+   DTRACE_PROBE4( mulle_objc, name, a, b, c, d)
+# define MULLE_OBJC_PROBE5( name, a, b, c, d, e)  \
+   DTRACE_PROBE5( mulle_objc, name, a, b, c, d, e)
+
+#else
+
+# define MULLE_OBJC_PROBE( name)                  do {} while( 0)
+# define MULLE_OBJC_PROBE1( name, a)              do {} while( 0)
+# define MULLE_OBJC_PROBE2( name, a, b)           do {} while( 0)
+# define MULLE_OBJC_PROBE3( name, a, b, c)        do {} while( 0)
+# define MULLE_OBJC_PROBE4( name, a, b, c, d)     do {} while( 0)
+# define MULLE_OBJC_PROBE5( name, a, b, c, d, e)  do {} while( 0)
+
+#endif
+
+#endif
@@ -0,0 +1,162 @@
+//
+//  mulle-objc-profile.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-profile.h"
+
+#include "mulle-objc-universe.h"
+
+#include "include-private.h"
+
+#include <string.h>
+
+
+static void   _mulle_objc_profilebuffer_add( struct _mulle_objc_profilebuffer *buffer,
+                                             struct _mulle_objc_class *cls,
+                                             mulle_objc_methodid_t methodid,
+                                             mulle_objc_implementation_t imp,
+                                             void *caller)
+{
+   struct _mulle_objc_profilesample   *p;
+   uintptr_t                          hash;
+   unsigned int                       i;
+   unsigned int                       n;
+
+   hash = ((uintptr_t) caller >> 2) ^ ((uintptr_t) cls >> 4) ^ methodid;
+   for( n = 0; n < MULLE_OBJC_PROFILEBUFFER_SIZE; n++)
+   {
+      i = (unsigned int) (hash + n) & (MULLE_OBJC_PROFILEBUFFER_SIZE - 1);
+      p = &buffer->samples[ i];
+      if( ! p->count)
+      {
+         p->cls      = cls;
+         p->methodid = methodid;
+         p->imp      = imp;
+         p->caller   = caller;
+         p->count    = 1;
+         return;
+      }
+
+      if( p->caller == caller && p->cls == cls && p->methodid == methodid)
+      {
+         ++p->count;
+         return;
+      }
+   }
+   ++buffer->dropped;
+}
+
+
+static struct _mulle_objc_profilebuffer   *
+   _mulle_objc_universe_new_profilebuffer( struct _mulle_objc_universe *universe,
+                                           struct _mulle_objc_threadinfo *config)
+{
+   struct _mulle_objc_profilebuffer   *buffer;
+   struct _mulle_objc_profilebuffer   *head;
+
+   //
+   // use the stdlib allocator, the buffers outlive the thread and
+   // shouldn't show up as leaks in tests
+   //
+   buffer = mulle_allocator_calloc( &mulle_stdlib_allocator, 1, sizeof( *buffer));
+   buffer->threadnr  = _mulle_objc_threadinfo_get_nr( config);
+   buffer->countdown = universe->debug.profile.method_call;
+
+   do
+   {
+      head         = _mulle_atomic_pointer_read( &universe->debug.profile.buffers);
+      buffer->next = head;
+   }
+   while( ! _mulle_atomic_pointer_cas( &universe->debug.profile.buffers, buffer, head));
+
+   config->profilebuffer = buffer;
+   return( buffer);
+}
+
+
+void   _mulle_objc_universe_profile_call( struct _mulle_objc_universe *universe,
+                                          struct _mulle_objc_class *cls,
+                                          mulle_objc_methodid_t methodid,
+                                          mulle_objc_implementation_t imp,
+                                          void *caller)
+{
+   struct _mulle_objc_threadinfo      *config;
+   struct _mulle_objc_profilebuffer   *buffer;
+
+   // threadinfo maybe already gone, if called in tss destructor
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( ! config)
+      return;
+
+   buffer = config->profilebuffer;
+   if( ! buffer)
+      buffer = _mulle_objc_universe_new_profilebuffer( universe, config);
+
+   if( --buffer->countdown)
+      return;
+   buffer->countdown = universe->debug.profile.method_call;
+
+   _mulle_objc_profilebuffer_add( buffer, cls, methodid, imp, caller);
+}
+
+
+struct _mulle_objc_profilebuffer   *
+   _mulle_objc_universe_get_profilebuffers( struct _mulle_objc_universe *universe)
+{
+   return( _mulle_atomic_pointer_read( &universe->debug.profile.buffers));
+}
+
+
+void   _mulle_objc_universe_free_profilebuffers( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_profilebuffer   *buffer;
+   struct _mulle_objc_profilebuffer   *next;
+   struct _mulle_objc_threadinfo      *config;
+
+   universe->debug.profile.method_call = 0;
+
+   // our own thread may still reference its buffer
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( config)
+      config->profilebuffer = NULL;
+
+   buffer = _mulle_atomic_pointer_read( &universe->debug.profile.buffers);
+   _mulle_atomic_pointer_nonatomic_write( &universe->debug.profile.buffers, NULL);
+
+   for( ; buffer; buffer = next)
+   {
+      next = buffer->next;
+      mulle_allocator_free( &mulle_stdlib_allocator, buffer);
+   }
+}
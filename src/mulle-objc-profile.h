@@ -0,0 +1,106 @@
+//
+//  mulle-objc-profile.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_profile_h__
+#define mulle_objc_profile_h__
+
+#include "mulle-objc-atomicpointer.h"
+#include "mulle-objc-method.h"
+#include "mulle-objc-uniqueid.h"
+
+#include "include.h"
+
+
+struct _mulle_objc_class;
+struct _mulle_objc_universe;
+
+//
+// Sampling method call profiler, enabled with MULLE_OBJC_PROFILE_METHOD_CALL
+// set to the sample interval N. The method caches stay on, but classes get
+// the instrumented cache lookups, that are also used for counting cache
+// hits. Calls are seen on cache misses in
+// _mulle_objc_object_call_class_nofail and on hits in the instrumented
+// lookups, but not on first slot hits of mulle_objc_object_call_inline.
+// Fast methods are not cached while profiling. Every Nth of the seen calls
+// is recorded into a buffer of the calling thread, without locking and
+// without I/O. Identical samples are aggregated into one entry with a count.
+//
+// The buffers are linked into the universe and stay alive after their
+// thread exits. They are dumped when the universe winds down, and freed
+// once nobody can message anymore.
+//
+#ifndef MULLE_OBJC_PROFILEBUFFER_SIZE
+# define MULLE_OBJC_PROFILEBUFFER_SIZE   4096   // power of 2
+#endif
+
+
+struct _mulle_objc_profilesample
+{
+   struct _mulle_objc_class      *cls;       // class of receiver
+   mulle_objc_methodid_t         methodid;
+   mulle_objc_implementation_t   imp;
+   void                          *caller;    // return address
+   uintptr_t                     count;
+};
+
+
+struct _mulle_objc_profilebuffer
+{
+   struct _mulle_objc_profilebuffer   *next;
+   uintptr_t                          threadnr;
+   unsigned int                       countdown;
+   uintptr_t                          dropped;  // samples that didn't fit
+   struct _mulle_objc_profilesample   samples[ MULLE_OBJC_PROFILEBUFFER_SIZE];
+};
+
+
+MULLE_C_NONNULL_FIRST_SECOND
+void   _mulle_objc_universe_profile_call( struct _mulle_objc_universe *universe,
+                                          struct _mulle_objc_class *cls,
+                                          mulle_objc_methodid_t methodid,
+                                          mulle_objc_implementation_t imp,
+                                          void *caller);
+
+// list of all buffers, walk with ->next
+MULLE_C_NONNULL_FIRST
+struct _mulle_objc_profilebuffer   *
+   _mulle_objc_universe_get_profilebuffers( struct _mulle_objc_universe *universe);
+
+// stops profiling and frees all buffers, only call this when no other
+// thread can profile anymore
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_universe_free_profilebuffers( struct _mulle_objc_universe *universe);
+
+#endif
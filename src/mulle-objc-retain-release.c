@@ -37,6 +37,7 @@
 
 #include "mulle-objc-call.h"
 #include "mulle-objc-object-convenience.h"
+#include "mulle-objc-probe.h"
 
 
 
@@ -88,6 +89,7 @@ void  _mulle_objc_object_tryfinalizetrydealloc( void *obj)
       retaincount_1 += INTPTR_MIN + 1;
       _mulle_atomic_pointer_write( &header->_retaincount_1, (void *) retaincount_1);
 
+      MULLE_OBJC_PROBE1( object__finalize, obj);
       _mulle_objc_object_finalize( obj);
 
       // reread
@@ -98,6 +100,7 @@ void  _mulle_objc_object_tryfinalizetrydealloc( void *obj)
    {
       // set it back to be nice
       _mulle_atomic_pointer_write( &header->_retaincount_1, (void *) -1);
+      MULLE_OBJC_PROBE1( object__dealloc, obj);
       _mulle_objc_object_dealloc( obj);
    }
 }
@@ -128,17 +131,52 @@ void  _mulle_objc_object_perform_finalize( void *obj)
                                        (void *) new_retaincount_1,
                                        (void *) retaincount_1));
 
+   MULLE_OBJC_PROBE1( object__finalize, obj);
    _mulle_objc_object_finalize( obj);
 }
 
 
+//
+// bit i is set, if objects[ i] is neither nil nor a tagged pointer. There
+// are no branches, so the compiler can vectorize this.
+//
+#define MULLE_OBJC_OBJECTS_BLOCK   8
+
+static inline unsigned int   _mulle_objc_objects_get_realmask( void **objects)
+{
+   uintptr_t      tagmask;
+   uintptr_t      p;
+   unsigned int   mask;
+   unsigned int   i;
+
+   tagmask = mulle_objc_get_taggedpointer_mask();
+   mask    = 0;
+   for( i = 0; i < MULLE_OBJC_OBJECTS_BLOCK; i++)
+   {
+      p     = (uintptr_t) objects[ i];
+      mask |= (unsigned int) ((p != 0) & ((p & tagmask) == 0)) << i;
+   }
+   return( mask);
+}
+
+
 void   _mulle_objc_objects_retain( void **objects, size_t n)
 {
-   void   **sentinel;
-   void   *p;
+   void           **sentinel;
+   void           **block;
+   void           *p;
+   unsigned int   mask;
 
-   // assume compiler can do unrolling
-   sentinel = &objects[ n];
+   sentinel = &objects[ n - n % MULLE_OBJC_OBJECTS_BLOCK];
+   for( ; objects < sentinel; objects += MULLE_OBJC_OBJECTS_BLOCK)
+   {
+      mask = _mulle_objc_objects_get_realmask( objects);
+      for( block = objects; mask; mask >>= 1, block++)
+         if( mask & 1)
+            __mulle_objc_object_increment_retaincount( *block);
+   }
+
+   sentinel = &objects[ n % MULLE_OBJC_OBJECTS_BLOCK];
    while( objects < sentinel)
    {
       p = *objects++;
@@ -150,12 +188,21 @@ void   _mulle_objc_objects_retain( void **objects, size_t n)
 
 void   _mulle_objc_objects_release( void **objects, size_t n)
 {
-   void   **sentinel;
-   void   *p;
+   void           **sentinel;
+   void           **block;
+   void           *p;
+   unsigned int   mask;
 
-   // assume compiler can do unrolling
-   sentinel = &objects[ n];
+   sentinel = &objects[ n - n % MULLE_OBJC_OBJECTS_BLOCK];
+   for( ; objects < sentinel; objects += MULLE_OBJC_OBJECTS_BLOCK)
+   {
+      mask = _mulle_objc_objects_get_realmask( objects);
+      for( block = objects; mask; mask >>= 1, block++)
+         if( mask & 1)
+            __mulle_objc_object_release_inline( *block);
+   }
 
+   sentinel = &objects[ n % MULLE_OBJC_OBJECTS_BLOCK];
    while( objects < sentinel)
    {
       p = *objects++;
@@ -167,12 +214,26 @@ void   _mulle_objc_objects_release( void **objects, size_t n)
 
 void   _mulle_objc_objects_releaseandzero( void **objects, size_t n)
 {
-   void   **sentinel;
-   void   *p;
-
-   // assume compiler can do unrolling
-   sentinel = &objects[ n];
+   void           **sentinel;
+   void           *copy[ MULLE_OBJC_OBJECTS_BLOCK];
+   void           **block;
+   void           *p;
+   unsigned int   mask;
+
+   sentinel = &objects[ n - n % MULLE_OBJC_OBJECTS_BLOCK];
+   for( ; objects < sentinel; objects += MULLE_OBJC_OBJECTS_BLOCK)
+   {
+      // zero before release, like below
+      memcpy( copy, objects, sizeof( copy));
+      memset( objects, 0, sizeof( copy));
+
+      mask = _mulle_objc_objects_get_realmask( copy);
+      for( block = copy; mask; mask >>= 1, block++)
+         if( mask & 1)
+            __mulle_objc_object_release_inline( *block);
+   }
 
+   sentinel = &objects[ n % MULLE_OBJC_OBJECTS_BLOCK];
    while( objects < sentinel)
    {
       p = *objects++;
@@ -90,12 +90,12 @@ static inline intptr_t   mulle_objc_object_get_retaincount( void *obj)
 }
 
 
-static inline void   _mulle_objc_object_increment_retaincount( void *obj)
+// obj must not be a tagged pointer
+static inline void   __mulle_objc_object_increment_retaincount( void *obj)
 {
    struct _mulle_objc_objectheader    *header;
 
-   if( mulle_objc_taggedpointer_get_index( obj))
-      return;
+   assert( ! mulle_objc_taggedpointer_get_index( obj));
 
    header = _mulle_objc_object_get_objectheader( obj);
    if( (intptr_t) _mulle_atomic_pointer_read( &header->_retaincount_1) != MULLE_OBJC_NEVER_RELEASE)
@@ -103,6 +103,15 @@ static inline void   _mulle_objc_object_increment_retaincount( void *obj)
 }
 
 
+static inline void   _mulle_objc_object_increment_retaincount( void *obj)
+{
+   if( mulle_objc_taggedpointer_get_index( obj))
+      return;
+
+   __mulle_objc_object_increment_retaincount( obj);
+}
+
+
 static inline int   _mulle_objc_object_decrement_retaincount_waszero( void *obj)
 {
    struct _mulle_objc_objectheader    *header;
@@ -171,12 +180,12 @@ static inline int   _mulle_objc_object_is_constant( void *obj)
 // __builtin_expect( --header->retaincount_1 < 0, 0)
 // didnt do anything for me
 //
-static inline void   _mulle_objc_object_release_inline( void *obj)
+// obj must not be a tagged pointer
+static inline void   __mulle_objc_object_release_inline( void *obj)
 {
    struct _mulle_objc_objectheader    *header;
 
-   if( mulle_objc_taggedpointer_get_index( obj))
-      return;
+   assert( ! mulle_objc_taggedpointer_get_index( obj));
 
    header = _mulle_objc_object_get_objectheader( obj);
 
@@ -193,6 +202,15 @@ static inline void   _mulle_objc_object_release_inline( void *obj)
 }
 
 
+static inline void   _mulle_objc_object_release_inline( void *obj)
+{
+   if( mulle_objc_taggedpointer_get_index( obj))
+      return;
+
+   __mulle_objc_object_release_inline( obj);
+}
+
+
 //
 // IDEA: on transition from 0 -> 1 could "seal" an instance, as this
 //       indicates setup is over. So all modifications except retain
@@ -233,6 +251,10 @@ void   mulle_objc_object_release( void *obj);
 # pragma mark - API
 
 
+//
+// These skip nil and tagged pointers in blocks of eight with a branch free
+// mask, so arrays of mostly tagged pointers are cheap.
+//
 void   _mulle_objc_objects_retain( void **objects, size_t n);
 void   _mulle_objc_objects_release( void **objects, size_t n);
 void   _mulle_objc_objects_releaseandzero( void **objects, size_t n);
@@ -76,6 +76,7 @@
 
 #include "mulle-metaabi.h"
 
+#include "mulle-objc-allocstats.h"
 #include "mulle-objc-atomicpointer.h"
 #include "mulle-objc-builtin.h"
 #include "mulle-objc-call.h"
@@ -84,13 +85,16 @@
 #include "mulle-objc-class-convenience.h"
 #include "mulle-objc-class-search.h"
 #include "mulle-objc-class-struct.h"
+#include "mulle-objc-epoch.h"
 #include "mulle-objc-fastclasstable.h"
 #include "mulle-objc-fastmethodtable.h"
 #include "mulle-objc-infraclass.h"
 #include "mulle-objc-ivar.h"
 #include "mulle-objc-ivarlist.h"
 #include "mulle-objc-kvccache.h"
+#include "mulle-objc-kvcplan.h"
 #include "mulle-objc-load.h"
+#include "mulle-objc-marshalplan.h"
 #include "mulle-objc-metaclass.h"
 #include "mulle-objc-method.h"
 #include "mulle-objc-methodidconstants.h"
@@ -98,6 +102,7 @@
 #include "mulle-objc-object.h"
 #include "mulle-objc-objectheader.h"
 #include "mulle-objc-object-convenience.h"
+#include "mulle-objc-profile.h"
 #include "mulle-objc-property.h"
 #include "mulle-objc-propertylist.h"
 #include "mulle-objc-retain-release.h"
@@ -108,8 +113,11 @@
 #include "mulle-objc-universe-global.h"
 #include "mulle-objc-universe-struct.h"
 #include "mulle-objc-signature.h"
+#include "mulle-objc-signatureinfo.h"
 #include "mulle-objc-super.h"
 #include "mulle-objc-taggedpointer.h"
+#include "mulle-objc-traceevent.h"
+#include "mulle-objc-tracering.h"
 #include "mulle-objc-try-catch-finally.h"
 #include "mulle-objc-uniqueid.h"
 #include "mulle-objc-uniqueidarray.h"
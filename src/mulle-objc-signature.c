@@ -128,18 +128,46 @@ static int   _mulle_objc_signature_supply_scalar_typeinfo( char c, struct mulle_
 }
 
 
+//
+// parse the decimal length of an array or bitfield, it must fit into
+// n_members. Returns NULL for missing or too large lengths
+//
+static char  *_mulle_objc_signature_parse_length( char *type, unsigned int *p_len)
+{
+   unsigned int   len;
+
+   if( *type < '0' || *type > '9')
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   len = 0;
+   do
+   {
+      len = len * 10 + (unsigned int) (*type++ - '0');
+      if( len > UINT16_MAX)
+      {
+         errno = EINVAL;
+         return( NULL);
+      }
+   }
+   while( *type >= '0' && *type <= '9');
+
+   *p_len = len;
+   return( type);
+}
+
+
 static char  *_mulle_objc_signature_supply_bitfield_typeinfo( char *type,
                                                               int level,
                                                               struct mulle_objc_typeinfo *info)
 {
-   int   len;
+   unsigned int   len;
 
-   len = atoi( type);
-   if( (uint16_t) len != len)
-      abort();
-
-   while( *type >= '0' && *type <= '9')
-      ++type;
+   type = _mulle_objc_signature_parse_length( type, &len);
+   if( ! type)
+      return( NULL);
 
    if( info)
    {
@@ -155,15 +183,16 @@ static char  *_mulle_objc_signature_supply_bitfield_typeinfo( char *type,
 }
 
 
-static void   _update_array_typeinfo_with_length( struct mulle_objc_typeinfo *info,
-                                                  unsigned int len)
+static int   _update_array_typeinfo_with_length( struct mulle_objc_typeinfo *info,
+                                                 unsigned int len)
 {
-   if( (uint16_t) len != len)
-      abort();
+   if( info->bits_size > UINT32_MAX / len)
+      return( -1);
 
    info->bits_size    *= len;
    info->natural_size *= len;
    info->n_members     = (uint16_t) len;
+   return( 0);
 }
 
 
@@ -173,36 +202,39 @@ static char  *
                                                 struct mulle_objc_typeinfo *info,
                                                 mulle_objc_scalar_typeinfo_supplier_t supplier)
 {
-   int   len;
-   char  *memoType;
+   unsigned int   len;
+   char           *memoType;
+
+   type = _mulle_objc_signature_parse_length( type, &len);
+   if( ! type || ! len)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
 
    // compiler lameness
    memoType = NULL;
-   len      = 0;
    if( info)
-   {
       memoType = info->type;
-      len      = atoi( type);
-      assert( len);
-   }
-
-   while( *type >= '0' && *type <= '9')
-      ++type;
 
    // reuse info, we remember the important parts
    type = _mulle_objc_type_parse( type, level, info, supplier);
-   if( type)
+   if( ! type || *type != _C_ARY_E)
    {
-      if( info)
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   if( info)
+   {
+      if( _update_array_typeinfo_with_length( info, len))
       {
-         _update_array_typeinfo_with_length( info, len);
-         info->type = memoType;
+         errno = EINVAL;
+         return( NULL);
       }
-
-      assert( *type == _C_ARY_E);
-      ++type;
+      info->type = memoType;
    }
-   return( type);
+   return( ++type);
 }
 
 
@@ -242,8 +274,6 @@ _update_struct_typeinfo_with_subsequent_member_typeinfo( struct mulle_objc_typei
 
 static inline void   _finalize_struct_typeinfo( struct mulle_objc_typeinfo *info, unsigned int n)
 {
-   if( (uint16_t) n != n)
-      abort();
 
    if( info->bits_struct_alignment < alignof( int) * 8)
       info->bits_struct_alignment = (uint16_t) (alignof( int) * 8);  // that's right AFAIK
@@ -306,6 +336,11 @@ static char  *_mulle_objc_signature_supply_struct_typeinfo( char *type,
             _update_struct_typeinfo_with_subsequent_member_typeinfo( info, tmp);
       }
 
+      if( n == UINT16_MAX)  // must fit n_members
+      {
+         errno = EINVAL;
+         return( NULL);
+      }
       ++n;
    }
 }
@@ -331,9 +366,6 @@ static void   _update_union_typeinfo_with_member_typeinfo( struct mulle_objc_typ
 static inline void   _finalize_union_typeinfo( struct mulle_objc_typeinfo *info,
                                                unsigned int n)
 {
-   if( (uint16_t) n != n)
-      abort();
-
    info->n_members = (uint16_t) n;
 }
 
@@ -384,6 +416,12 @@ static char  *
       // largest of anything wins
       if( tmp)
          _update_union_typeinfo_with_member_typeinfo( info, tmp);
+
+      if( n == UINT16_MAX)  // must fit n_members
+      {
+         errno = EINVAL;
+         return( NULL);
+      }
       ++n;
    }
 }
@@ -481,7 +519,7 @@ static char   *
       info->n_members         = 0;
    }
    else
-      isComplex = is_multi_character_type( *type);
+      isComplex = *type ? is_multi_character_type( *type) : -1;
 
    // isComplex == -1: error
    switch( isComplex)
@@ -598,7 +636,17 @@ char   *_mulle_objc_signature_supply_typeinfo( char *types,
       if( info)
          info->name = next;
 
-      while( *++next != '"');
+      for(;;)
+      {
+         c = *++next;
+         if( ! c)
+         {
+            errno = EINVAL;
+            return( NULL);
+         }
+         if( c == '"')
+            break;
+      }
       ++next;  // skip terminator
    }
 
@@ -926,6 +974,34 @@ int   _mulle_objc_signature_compare_lenient( char *a, char *b)
 }
 
 
+//
+// hash over the pure types of the arguments, signatures that compare
+// equal with _mulle_objc_signature_compare_lenient have the same hash.
+// Like the compare the return value is ignored.
+//
+uint32_t   _mulle_objc_signature_get_lenienthash( char *types)
+{
+   struct mulle_objc_typeinfo   info;
+   uint32_t                     hash;
+
+   hash = MULLE_FNV1A_32_INIT;
+
+   // skip return value
+   types = _mulle_objc_signature_supply_typeinfo( types, NULL, &info);
+   while( types)
+   {
+      types = _mulle_objc_signature_supply_typeinfo( types, NULL, &info);
+      if( ! types)
+         break;
+
+      hash = _mulle_fnv1a_chained_32( info.type,
+                                      info.pure_type_end - info.type,
+                                      hash);
+   }
+   return( hash);
+}
+
+
 int   mulle_objc_signature_contains_retainableobject( char *type)
 {
    struct mulle_objc_typeinfo   info;
@@ -322,6 +322,9 @@ int   _mulle_objc_typeinfo_compare( struct mulle_objc_typeinfo *a,
 
 int  _mulle_objc_signature_compare_lenient( char *a, char *b);
 
+// computed once, this is cheaper than repeated lenient compares
+uint32_t   _mulle_objc_signature_get_lenienthash( char *types);
+
 //
 // this also checks the return values, which is all in all not very useful
 // in real life.
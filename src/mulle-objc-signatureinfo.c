@@ -0,0 +1,317 @@
+//
+//  mulle-objc-signatureinfo.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-signatureinfo.h"
+
+#include "mulle-objc-method.h"
+#include "mulle-objc-universe.h"
+
+#include "include-private.h"
+#include <errno.h>
+
+
+# pragma mark - hash
+
+mulle_objc_uniqueid_t   _mulle_objc_signature_get_signatureid( char *signature)
+{
+   mulle_objc_uniqueid_t   value;
+
+   value = _mulle_fnv1a_32( signature, strlen( signature));
+   // keep out of the way of the hashmap
+   if( value == MULLE_OBJC_NO_UNIQUEID || value == MULLE_OBJC_INVALID_UNIQUEID)
+      value = 0x1848;
+   return( value);
+}
+
+
+# pragma mark - create/free
+
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_signatureinfo_new( char *signature,
+                                  struct mulle_allocator *allocator)
+{
+   struct _mulle_objc_signatureinfo        *info;
+   struct mulle_objc_signatureenumerator   rover;
+   struct mulle_objc_typeinfo              *p;
+   unsigned int                            n;
+   unsigned int                            i;
+   size_t                                  size;
+   size_t                                  len;
+   char                                    *s;
+
+   if( ! signature || ! *signature)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   n = mulle_objc_signature_count_typeinfos( signature);
+   if( ! n)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   len  = strlen( signature) + 1;
+   size = sizeof( struct _mulle_objc_signatureinfo) +
+          sizeof( struct mulle_objc_typeinfo) * (n - 1);
+   info = mulle_allocator_calloc( allocator, 1, size + len);
+
+   // the typeinfos will point into this copy
+   s = &((char *) info)[ size];
+   memcpy( s, signature, len);
+
+   info->signature   = s;
+   info->signatureid = _mulle_objc_signature_get_signatureid( s);
+   info->n           = n;
+
+   i     = 1;
+   rover = mulle_objc_signature_enumerate( s);
+   {
+      p = &info->typeinfos[ 1];
+      while( i < n && _mulle_objc_signatureenumerator_next( &rover, p))
+      {
+         ++p;
+         ++i;
+      }
+      _mulle_objc_signatureenumerator_rval( &rover, &info->typeinfos[ 0]);
+   }
+   mulle_objc_signatureenumerator_done( &rover);
+
+   // parse error or count mismatch
+   if( i != n || ! info->typeinfos[ 0].type)
+   {
+      mulle_allocator_free( allocator, info);
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   info->paramtype   = mulle_objc_signature_get_metaabiparamtype( s);
+   info->returntype  = mulle_objc_signature_get_metaabireturntype( s);
+   info->metaabisize = mulle_metaabi_sizeof_struct( info->typeinfos[ 0].invocation_offset +
+                                                    info->typeinfos[ 0].natural_size);
+   return( info);
+}
+
+
+void   _mulle_objc_signatureinfo_free( struct _mulle_objc_signatureinfo *info,
+                                       struct mulle_allocator *allocator)
+{
+   mulle_allocator_free( allocator, info);
+}
+
+
+# pragma mark - universe
+
+static struct _mulle_objc_signatureinfo   *
+   _mulle_objc_signatureinfo_find_in_chain( struct _mulle_objc_signatureinfo *info,
+                                            char *signature)
+{
+   for( ; info; info = _mulle_atomic_pointer_read( &info->next))
+      if( ! strcmp( info->signature, signature))
+         return( info);
+   return( NULL);
+}
+
+
+//
+// Append info to the chain, unless an info with the same signature is
+// already there, which is then returned. Infos are never removed, so the
+// chain only grows at the end.
+//
+static struct _mulle_objc_signatureinfo   *
+   _mulle_objc_signatureinfo_chain( struct _mulle_objc_signatureinfo *entry,
+                                    struct _mulle_objc_signatureinfo *info)
+{
+   struct _mulle_objc_signatureinfo   *next;
+
+   for(;;)
+   {
+      if( ! strcmp( entry->signature, info->signature))
+         return( entry);
+
+      next = _mulle_atomic_pointer_read( &entry->next);
+      if( ! next)
+      {
+         if( _mulle_atomic_pointer_cas( &entry->next, info, NULL))
+            return( info);
+         next = _mulle_atomic_pointer_read( &entry->next);
+      }
+      entry = next;
+   }
+}
+
+
+//
+// Signatures are found by their hash and then compared, as signatures are
+// not unique like selectors. Different signatures with the same hash are
+// chained.
+//
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_lookup_signatureinfo( struct _mulle_objc_universe *universe,
+                                              char *signature)
+{
+   struct _mulle_objc_signatureinfo   *info;
+   mulle_objc_uniqueid_t              signatureid;
+
+   signatureid = _mulle_objc_signature_get_signatureid( signature);
+   info        = _mulle_concurrent_hashmap_lookup( &universe->signaturetable, signatureid);
+   return( _mulle_objc_signatureinfo_find_in_chain( info, signature));
+}
+
+
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_register_signatureinfo( struct _mulle_objc_universe *universe,
+                                                char *signature)
+{
+   struct _mulle_objc_signatureinfo   *info;
+   struct _mulle_objc_signatureinfo   *dup;
+   struct mulle_allocator             *allocator;
+
+   if( ! signature || ! *signature)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   info = _mulle_objc_universe_lookup_signatureinfo( universe, signature);
+   if( info)
+      return( info);
+
+   allocator = _mulle_objc_universe_get_allocator( universe);
+   info      = _mulle_objc_signatureinfo_new( signature, allocator);
+   if( ! info)
+      return( NULL);
+
+   dup = _mulle_concurrent_hashmap_register( &universe->signaturetable,
+                                             info->signatureid,
+                                             info);
+   if( ! dup)
+      return( info);
+
+   // must be out of mem
+   if( dup == MULLE_CONCURRENT_INVALID_POINTER)
+   {
+      _mulle_objc_signatureinfo_free( info, allocator);
+      return( NULL);
+   }
+
+   // someone else was faster, or a hash collision, which is chained
+   dup = _mulle_objc_signatureinfo_chain( dup, info);
+   if( dup != info)
+      _mulle_objc_signatureinfo_free( info, allocator);
+   return( dup);
+}
+
+
+//
+// The signatureinfo of a descriptor is kept by methodid, so it's found
+// without hashing the signature. Descriptors with the same methodid may
+// differ in their signature strings (e.g. offsets), but not in the types,
+// which the signatureinfo is about. This is checked in debug builds.
+//
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_lookup_signatureinfo_for_descriptor( struct _mulle_objc_universe *universe,
+                                                             struct _mulle_objc_descriptor *desc)
+{
+   struct _mulle_objc_signatureinfo   *info;
+
+   info = _mulle_concurrent_hashmap_lookup( &universe->methodsignaturetable,
+                                            _mulle_objc_descriptor_get_methodid( desc));
+#ifndef NDEBUG
+   if( info &&
+       strcmp( info->signature, _mulle_objc_descriptor_get_signature( desc)) &&
+       _mulle_objc_signature_compare_lenient( info->signature, _mulle_objc_descriptor_get_signature( desc)))
+      mulle_objc_universe_fail_inconsistency( universe,
+               "signature \"%s\" of \"%s\" differs from \"%s\" of the same id %08x",
+               _mulle_objc_descriptor_get_signature( desc),
+               _mulle_objc_descriptor_get_name( desc),
+               info->signature,
+               _mulle_objc_descriptor_get_methodid( desc));
+#endif
+   return( info);
+}
+
+
+struct _mulle_objc_signatureinfo   *
+   mulle_objc_universe_register_signatureinfo_for_descriptor( struct _mulle_objc_universe *universe,
+                                                              struct _mulle_objc_descriptor *desc)
+{
+   struct _mulle_objc_signatureinfo   *info;
+   struct _mulle_objc_signatureinfo   *dup;
+
+   if( ! universe || ! desc)
+   {
+      errno = EINVAL;
+      return( NULL);
+   }
+
+   info = _mulle_objc_universe_lookup_signatureinfo_for_descriptor( universe, desc);
+   if( info)
+      return( info);
+
+   info = _mulle_objc_universe_register_signatureinfo( universe,
+                                                       _mulle_objc_descriptor_get_signature( desc));
+   if( ! info)
+      return( NULL);
+
+   // infos are owned by the signaturetable, so a dup is no problem
+   dup = _mulle_concurrent_hashmap_register( &universe->methodsignaturetable,
+                                             _mulle_objc_descriptor_get_methodid( desc),
+                                             info);
+   if( dup == MULLE_CONCURRENT_INVALID_POINTER)
+      return( NULL);
+   return( dup ? dup : info);
+}
+
+
+void   _mulle_objc_universe_free_signatureinfos( struct _mulle_objc_universe *universe)
+{
+   struct mulle_concurrent_hashmapenumerator   rover;
+   struct _mulle_objc_signatureinfo            *info;
+   struct _mulle_objc_signatureinfo            *next;
+   struct mulle_allocator                      *allocator;
+
+   allocator = _mulle_objc_universe_get_allocator( universe);
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->signaturetable);
+   while( _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &info))
+      for( ; info; info = next)
+      {
+         next = _mulle_atomic_pointer_read( &info->next);
+         _mulle_objc_signatureinfo_free( info, allocator);
+      }
+   mulle_concurrent_hashmapenumerator_done( &rover);
+}
@@ -0,0 +1,195 @@
+//
+//  mulle-objc-signatureinfo.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_signatureinfo_h__
+#define mulle_objc_signatureinfo_h__
+
+#include "mulle-objc-atomicpointer.h"
+#include "mulle-objc-signature.h"
+#include "mulle-objc-uniqueid.h"
+
+#include "include.h"
+
+
+struct _mulle_objc_descriptor;
+struct _mulle_objc_universe;
+
+//
+// A signatureinfo is the parsed form of a signature string. The universe
+// keeps one signatureinfo per distinct signature, so all descriptors with
+// the same signature share it. The string is copied into the signatureinfo
+// and the typeinfos point into that copy.
+//
+// typeinfos[ 0] is the return value, typeinfos[ 1] is self, typeinfos[ 2]
+// is _cmd and so on. All invocation_offsets are valid, the one of the
+// return value is the offset computed by _mulle_objc_signatureenumerator_rval.
+//
+// Different signatures with the same signatureid are chained with next.
+//
+struct _mulle_objc_signatureinfo
+{
+   char                         *signature;
+   mulle_objc_uniqueid_t        signatureid;   // hash of signature
+   mulle_atomic_pointer_t       next;          // same signatureid
+   enum mulle_metaabi_param     paramtype;
+   enum mulle_metaabi_param     returntype;
+   size_t                       metaabisize;   // _mulle_objc_signature_sizeof_metabistruct
+   unsigned int                 n;             // rval + self + _cmd + args
+   struct mulle_objc_typeinfo   typeinfos[ 1]; // flexible
+};
+
+
+# pragma mark - create/free
+
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_signatureinfo_new( char *signature,
+                                  struct mulle_allocator *allocator);
+
+void   _mulle_objc_signatureinfo_free( struct _mulle_objc_signatureinfo *info,
+                                       struct mulle_allocator *allocator);
+
+
+# pragma mark - petty accessors
+
+static inline char   *
+   _mulle_objc_signatureinfo_get_signature( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->signature);
+}
+
+
+static inline mulle_objc_uniqueid_t
+   _mulle_objc_signatureinfo_get_signatureid( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->signatureid);
+}
+
+
+static inline enum mulle_metaabi_param
+   _mulle_objc_signatureinfo_get_metaabiparamtype( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->paramtype);
+}
+
+
+static inline enum mulle_metaabi_param
+   _mulle_objc_signatureinfo_get_metaabireturntype( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->returntype);
+}
+
+
+static inline size_t
+   _mulle_objc_signatureinfo_get_metaabisize( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->metaabisize);
+}
+
+
+// includes the return value
+static inline unsigned int
+   _mulle_objc_signatureinfo_get_count( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->n);
+}
+
+
+static inline unsigned int
+   _mulle_objc_signatureinfo_get_argumentcount( struct _mulle_objc_signatureinfo *info)
+{
+   return( info->n - 1);
+}
+
+
+static inline struct mulle_objc_typeinfo  *
+   _mulle_objc_signatureinfo_get_rvaltypeinfo( struct _mulle_objc_signatureinfo *info)
+{
+   return( &info->typeinfos[ 0]);
+}
+
+
+// i = 0 is self, i = 1 is _cmd
+static inline struct mulle_objc_typeinfo  *
+   _mulle_objc_signatureinfo_get_argumenttypeinfo( struct _mulle_objc_signatureinfo *info,
+                                                   unsigned int i)
+{
+   assert( i + 1 < info->n);
+   return( &info->typeinfos[ i + 1]);
+}
+
+
+# pragma mark - hash
+
+//
+// the signatureid is the hash used to find a signatureinfo, it's never
+// MULLE_OBJC_NO_UNIQUEID or MULLE_OBJC_INVALID_UNIQUEID
+//
+mulle_objc_uniqueid_t   _mulle_objc_signature_get_signatureid( char *signature);
+
+
+# pragma mark - universe
+
+//
+// returns NULL, if the signature hasn't been registered yet
+//
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_lookup_signatureinfo( struct _mulle_objc_universe *universe,
+                                              char *signature);
+
+//
+// returns the shared signatureinfo for signature, creating and registering
+// it if needed. Returns NULL and sets errno to EINVAL, if the signature
+// is empty or can not be parsed.
+//
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_register_signatureinfo( struct _mulle_objc_universe *universe,
+                                                char *signature);
+
+//
+// the descriptor variants find the signatureinfo by methodid, without
+// hashing the signature string
+//
+struct _mulle_objc_signatureinfo   *
+   _mulle_objc_universe_lookup_signatureinfo_for_descriptor( struct _mulle_objc_universe *universe,
+                                                             struct _mulle_objc_descriptor *desc);
+
+struct _mulle_objc_signatureinfo   *
+   mulle_objc_universe_register_signatureinfo_for_descriptor( struct _mulle_objc_universe *universe,
+                                                              struct _mulle_objc_descriptor *desc);
+
+// used by the universe on destruction
+void   _mulle_objc_universe_free_signatureinfos( struct _mulle_objc_universe *universe);
+
+#endif
@@ -138,4 +138,173 @@ static inline intptr_t   mulle_objc_taggedpointer_get_signed_value( void *pointe
    return( value >> mulle_objc_get_taggedpointer_shift());
 }
 
+
+# pragma mark - extended encodings
+
+//
+// The runtime doesn't care what's in a tagged pointer, but these are
+// encodings for the Foundation to use for classes, that hold small
+// strings or doubles. All bits above the index are the payload:
+//
+// ASCII   : [ c6 c5 c4 c3 c2 c1 c0 | len:4 ]        (64 bit: 7 chars)
+//           [ c2 c1 c0 | len:4 ]                    (32 bit: 3 chars)
+//           8 bits per char, c0 is the first char. Unused chars are 0.
+//           Only 1-127 are allowed, so each string has exactly one
+//           encoding and equal strings are equal pointers.
+//
+// double  : [ sign:1 | exp:8 | mantissa:52 ]        (64 bit only)
+//           like an IEEE double, but the exponent is rebiased to 8 bits.
+//           exp 1 ... 255 are the exponents -126 ... 128, so magnitudes
+//           from 2^-126 up to just below 2^129 can be encoded. exp 0 is
+//           +-0.0. Denormals, infinities and NaN can not be encoded,
+//           neither can values outside the range.
+//
+// The create functions return NULL, if the value can not be encoded, so
+// the caller can fall back to a heap object.
+//
+#define MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS   4
+#define MULLE_OBJC_TAGGEDPOINTER_DOUBLE_EXP_BITS     8
+
+
+static inline unsigned int   mulle_objc_taggedpointer_get_max_ascii_length( void)
+{
+   return( (sizeof( uintptr_t) * 8 - mulle_objc_get_taggedpointer_shift()
+            - MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS) / 8);
+}
+
+
+static inline int   mulle_objc_taggedpointer_is_valid_ascii( char *s, size_t len)
+{
+   size_t   i;
+
+   if( len > mulle_objc_taggedpointer_get_max_ascii_length())
+      return( 0);
+
+   for( i = 0; i < len; i++)
+      if( (unsigned char) (s[ i] - 1) >= 0x7F)  // 0 or >= 128
+         return( 0);
+   return( 1);
+}
+
+
+static inline void   *mulle_objc_create_ascii_taggedpointer( char *s,
+                                                             size_t len,
+                                                             unsigned int index)
+{
+   uintptr_t   value;
+   size_t      i;
+
+   assert( index > 0 && index <= mulle_objc_get_taggedpointer_mask());
+
+   if( ! mulle_objc_taggedpointer_is_valid_ascii( s, len))
+      return( NULL);
+
+   value = 0;
+   for( i = len; i;)
+      value = (value << 8) | (unsigned char) s[ --i];
+
+   value = (value << MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS) | len;
+   return( mulle_objc_create_unsigned_taggedpointer( value, index));
+}
+
+
+MULLE_C_ALWAYS_INLINE MULLE_C_CONST_RETURN
+static inline size_t   mulle_objc_taggedpointer_get_ascii_length( void *pointer)
+{
+   return( mulle_objc_taggedpointer_get_unsigned_value( pointer)
+           & ((1 << MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS) - 1));
+}
+
+
+//
+// buf must have space for mulle_objc_taggedpointer_get_max_ascii_length()
+// + 1 chars, the string will be zero terminated. Returns the length.
+//
+static inline size_t   mulle_objc_taggedpointer_get_ascii_chars( void *pointer,
+                                                                 char *buf)
+{
+   uintptr_t   value;
+   size_t      len;
+   size_t      i;
+
+   value = mulle_objc_taggedpointer_get_unsigned_value( pointer);
+   len   = value & ((1 << MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS) - 1);
+   value >>= MULLE_OBJC_TAGGEDPOINTER_ASCII_LENGTH_BITS;
+
+   for( i = 0; i < len; i++)
+   {
+      buf[ i] = (char) (value & 0xFF);
+      value >>= 8;
+   }
+   buf[ len] = 0;
+   return( len);
+}
+
+
+union _mulle_objc_taggeddouble
+{
+   double     d;
+   uint64_t   bits;
+};
+
+
+static inline void   *mulle_objc_create_double_taggedpointer( double d,
+                                                              unsigned int index)
+{
+   union _mulle_objc_taggeddouble   v;
+   uint64_t                         sign;
+   uint64_t                         exp;
+   uint64_t                         mantissa;
+   uint64_t                         value;
+   int64_t                          rebiased;
+
+   assert( index > 0 && index <= mulle_objc_get_taggedpointer_mask());
+
+   if( sizeof( uintptr_t) < sizeof( uint64_t))
+      return( NULL);
+
+   v.d      = d;
+   sign     = v.bits >> 63;
+   exp      = (v.bits >> 52) & 0x7FF;
+   mantissa = v.bits & ((1ULL << 52) - 1);
+
+   if( ! exp)
+   {
+      if( mantissa)         // denormal
+         return( NULL);
+      rebiased = 0;
+   }
+   else
+   {
+      // 1023 is the bias of the double, 127 is the one of the 8 bit exp
+      rebiased = (int64_t) exp - 1023 + 127;
+      if( rebiased <= 0 || rebiased >= (1 << MULLE_OBJC_TAGGEDPOINTER_DOUBLE_EXP_BITS))
+         return( NULL);     // also catches inf and NaN
+   }
+
+   value = (sign << (52 + MULLE_OBJC_TAGGEDPOINTER_DOUBLE_EXP_BITS))
+           | ((uint64_t) rebiased << 52)
+           | mantissa;
+   return( mulle_objc_create_unsigned_taggedpointer( (uintptr_t) value, index));
+}
+
+
+MULLE_C_ALWAYS_INLINE MULLE_C_CONST_RETURN
+static inline double   mulle_objc_taggedpointer_get_double_value( void *pointer)
+{
+   union _mulle_objc_taggeddouble   v;
+   uint64_t                         value;
+   uint64_t                         sign;
+   uint64_t                         exp;
+
+   value = (uint64_t) mulle_objc_taggedpointer_get_unsigned_value( pointer);
+   sign  = value >> (52 + MULLE_OBJC_TAGGEDPOINTER_DOUBLE_EXP_BITS);
+   exp   = (value >> 52) & ((1 << MULLE_OBJC_TAGGEDPOINTER_DOUBLE_EXP_BITS) - 1);
+   if( exp)
+      exp = exp + 1023 - 127;
+
+   v.bits = (sign << 63) | (exp << 52) | (value & ((1ULL << 52) - 1));
+   return( v.d);
+}
+
 #endif
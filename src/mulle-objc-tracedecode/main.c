@@ -0,0 +1,124 @@
+//
+//  main.c
+//  mulle-objc-tracedecode
+//
+//  Created by Nat! on 18.10.20
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-traceevent.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+static int   decode( FILE *fp, char *filename)
+{
+   struct mulle_objc_tracefileheader   header;
+   struct mulle_objc_traceevent        event;
+
+   if( fread( &header, sizeof( header), 1, fp) != 1)
+   {
+      fprintf( stderr, "%s: too short for a trace file\n", filename);
+      return( -1);
+   }
+
+   if( header.magic != MULLE_OBJC_TRACEFILE_MAGIC)
+   {
+      fprintf( stderr, "%s: not a trace file (or wrong byte order)\n", filename);
+      return( -1);
+   }
+
+   if( header.version != MULLE_OBJC_TRACEFILE_VERSION ||
+       header.recordsize != sizeof( struct mulle_objc_traceevent))
+   {
+      fprintf( stderr, "%s: unsupported trace file version %u (record size %u)\n",
+                       filename, header.version, header.recordsize);
+      return( -1);
+   }
+
+   while( fread( &event, sizeof( event), 1, fp) == 1)
+   {
+      printf( "%llu.%09llu t:#%u %-19s %08x %08x %p\n",
+              (unsigned long long) (event.timestamp / 1000000000),
+              (unsigned long long) (event.timestamp % 1000000000),
+              (unsigned int) event.threadnr,
+              mulle_objc_traceevent_type_name( event.type),
+              (unsigned int) event.classid,
+              (unsigned int) event.methodid,
+              (void *) (uintptr_t) event.pointer);
+   }
+
+   if( ferror( fp))
+   {
+      perror( filename);
+      return( -1);
+   }
+   return( 0);
+}
+
+
+int   main( int argc, char *argv[])
+{
+   FILE   *fp;
+   int    rval;
+   int    i;
+
+   if( argc < 2 || ! strlen( argv[ 1]))
+   {
+      fprintf( stderr, "Usage:\n   mulle-objc-tracedecode <file>*\n"
+                       "   Prints trace files written by the runtime, when\n"
+                       "   MULLE_OBJC_TRACE_FILE is set. Use \"-\" for stdin.\n"
+                       "\n");
+      return( -1);
+   }
+
+   rval = 0;
+   for( i = 1; i < argc; i++)
+   {
+      if( ! strcmp( argv[ i], "-"))
+      {
+         rval |= decode( stdin, "stdin");
+         continue;
+      }
+
+      fp = fopen( argv[ i], "rb");
+      if( ! fp)
+      {
+         perror( argv[ i]);
+         rval = -1;
+         continue;
+      }
+      rval |= decode( fp, argv[ i]);
+      fclose( fp);
+   }
+
+   return( rval ? 1 : 0);
+}
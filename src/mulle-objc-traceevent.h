@@ -0,0 +1,108 @@
+//
+//  mulle-objc-traceevent.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_traceevent_h__
+#define mulle_objc_traceevent_h__
+
+//
+// The binary trace format, written when MULLE_OBJC_TRACE_FILE is set. This
+// header has no dependencies, so that mulle-objc-tracedecode can use it
+// without the runtime.
+//
+// A trace file is a struct mulle_objc_tracefileheader followed by
+// struct mulle_objc_traceevent records. Records are in host byte order and
+// are sorted by thread, not by time, as each thread has its own buffer.
+//
+#include <stdint.h>
+
+
+#define MULLE_OBJC_TRACEFILE_MAGIC     0x52544f4d  // "MOTR"
+#define MULLE_OBJC_TRACEFILE_VERSION   1
+
+
+enum mulle_objc_traceevent_type
+{
+   mulle_objc_traceevent_none = 0,
+   mulle_objc_traceevent_method_call,          // pointer: imp
+   mulle_objc_traceevent_methodcache_initial,  // pointer: cache
+   mulle_objc_traceevent_methodcache_new,      // pointer: cache
+   mulle_objc_traceevent_methodcache_free,     // pointer: cache
+   mulle_objc_traceevent_classcache_new,       // pointer: cache
+   mulle_objc_traceevent_classcache_add,       // pointer: cache
+   mulle_objc_traceevent_classcache_free,      // pointer: cache
+   mulle_objc_traceevent_instance_alloc,       // pointer: instance, methodid: extra
+   mulle_objc_traceevent_max
+};
+
+
+static inline char   *mulle_objc_traceevent_type_name( unsigned int type)
+{
+   static char   *names[] =
+   {
+      "none",
+      "method-call",
+      "methodcache-initial",
+      "methodcache-new",
+      "methodcache-free",
+      "classcache-new",
+      "classcache-add",
+      "classcache-free",
+      "instance-alloc"
+   };
+
+   return( type < mulle_objc_traceevent_max ? names[ type] : "???");
+}
+
+
+struct mulle_objc_traceevent
+{
+   uint64_t   timestamp;  // ns, monotonic, 0 if not available
+   uint64_t   pointer;
+   uint32_t   type;
+   uint32_t   threadnr;   // threadinfo nr
+   uint32_t   classid;
+   uint32_t   methodid;
+};
+
+
+struct mulle_objc_tracefileheader
+{
+   uint32_t   magic;
+   uint32_t   version;
+   uint32_t   recordsize; // sizeof( struct mulle_objc_traceevent)
+   uint32_t   reserved;
+};
+
+#endif
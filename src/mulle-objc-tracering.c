@@ -0,0 +1,294 @@
+//
+//  mulle-objc-tracering.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#include "mulle-objc-tracering.h"
+
+#include "mulle-objc-universe.h"
+
+#include "include-private.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined( __linux__) || defined( __APPLE__)
+# define HAVE_TRACE_TIMESTAMP
+# include <time.h>
+#endif
+
+
+static inline uint64_t   trace_timestamp( void)
+{
+#ifdef HAVE_TRACE_TIMESTAMP
+   struct timespec   now;
+
+   clock_gettime( CLOCK_MONOTONIC, &now);
+   return( (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec);
+#else
+   return( 0);
+#endif
+}
+
+
+# pragma mark - consumer
+
+//
+// must be called with the debug lock held
+//
+static void   _mulle_objc_tracering_flush( struct _mulle_objc_tracering *ring,
+                                           FILE *fp)
+{
+   uintptr_t   read;
+   uintptr_t   write;
+   uintptr_t   i;
+   uintptr_t   n;
+
+   read  = (uintptr_t) _mulle_atomic_pointer_nonatomic_read( &ring->read);
+   write = (uintptr_t) _mulle_atomic_pointer_read( &ring->write);
+
+   while( read != write)
+   {
+      // write out contiguous chunks, up to the end of the ring
+      i = read & (MULLE_OBJC_TRACERING_SIZE - 1);
+      n = write - read;
+      if( n > MULLE_OBJC_TRACERING_SIZE - i)
+         n = MULLE_OBJC_TRACERING_SIZE - i;
+
+      fwrite( &ring->events[ i], sizeof( struct mulle_objc_traceevent), n, fp);
+      read += n;
+   }
+
+   _mulle_atomic_pointer_write( &ring->read, (void *) read);
+}
+
+
+static void   _mulle_objc_universe_flush_tracerings( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_tracering   *ring;
+   FILE                           *fp;
+
+   fp = universe->debug.tracefile.fp;
+   if( ! fp)
+      return;
+
+   ring = _mulle_atomic_pointer_read( &universe->debug.tracefile.rings);
+   for( ; ring; ring = ring->next)
+      _mulle_objc_tracering_flush( ring, fp);
+   fflush( fp);
+}
+
+
+void   mulle_objc_universe_flush_tracefile( struct _mulle_objc_universe *universe)
+{
+   if( ! universe)
+      return;
+
+   mulle_thread_mutex_lock( &universe->debug.lock);
+   {
+      _mulle_objc_universe_flush_tracerings( universe);
+   }
+   mulle_thread_mutex_unlock( &universe->debug.lock);
+}
+
+
+# pragma mark - producer
+
+static struct _mulle_objc_tracering   *
+   _mulle_objc_universe_new_tracering( struct _mulle_objc_universe *universe,
+                                       struct _mulle_objc_threadinfo *config)
+{
+   struct _mulle_objc_tracering   *ring;
+   struct _mulle_objc_tracering   *head;
+
+   // like the profile buffers, these outlive their thread
+   ring = mulle_allocator_calloc( &mulle_stdlib_allocator, 1, sizeof( *ring));
+   ring->threadnr = _mulle_objc_threadinfo_get_nr( config);
+
+   do
+   {
+      head       = _mulle_atomic_pointer_read( &universe->debug.tracefile.rings);
+      ring->next = head;
+   }
+   while( ! _mulle_atomic_pointer_cas( &universe->debug.tracefile.rings, ring, head));
+
+   config->tracering = ring;
+   return( ring);
+}
+
+
+void   _mulle_objc_universe_trace_event( struct _mulle_objc_universe *universe,
+                                         enum mulle_objc_traceevent_type type,
+                                         uint32_t classid,
+                                         uint32_t methodid,
+                                         void *pointer)
+{
+   struct _mulle_objc_threadinfo   *config;
+   struct _mulle_objc_tracering    *ring;
+   struct mulle_objc_traceevent    *event;
+   uintptr_t                       read;
+   uintptr_t                       write;
+   int                             preserve;
+
+   // threadinfo maybe already gone, if called in tss destructor
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( ! config)
+      return;
+
+   ring = config->tracering;
+   if( ! ring)
+      ring = _mulle_objc_universe_new_tracering( universe, config);
+
+   write = (uintptr_t) _mulle_atomic_pointer_nonatomic_read( &ring->write);
+   read  = (uintptr_t) _mulle_atomic_pointer_read( &ring->read);
+   if( write - read >= MULLE_OBJC_TRACERING_SIZE)
+   {
+      ++ring->dropped;
+      return;
+   }
+
+   event            = &ring->events[ write & (MULLE_OBJC_TRACERING_SIZE - 1)];
+   event->timestamp = trace_timestamp();
+   event->pointer   = (uint64_t) (uintptr_t) pointer;
+   event->type      = type;
+   event->threadnr  = (uint32_t) ring->threadnr;
+   event->classid   = classid;
+   event->methodid  = methodid;
+
+   // publish
+   _mulle_atomic_pointer_write( &ring->write, (void *) (write + 1));
+
+   // every half ring, flush unless someone else is at it already
+   if( ! ((write + 1) & (MULLE_OBJC_TRACERING_SIZE / 2 - 1)))
+   {
+      preserve = errno;
+      if( ! mulle_thread_mutex_trylock( &universe->debug.lock))
+      {
+         _mulle_objc_universe_flush_tracerings( universe);
+         mulle_thread_mutex_unlock( &universe->debug.lock);
+      }
+      errno = preserve;
+   }
+}
+
+
+# pragma mark - open/close
+
+int   _mulle_objc_universe_open_tracefile( struct _mulle_objc_universe *universe,
+                                           char *filename)
+{
+   struct mulle_objc_tracefileheader   header;
+   FILE                                *fp;
+
+   fp = fopen( filename, "wb");
+   if( ! fp)
+      return( -1);
+
+   memset( &header, 0, sizeof( header));
+   header.magic      = MULLE_OBJC_TRACEFILE_MAGIC;
+   header.version    = MULLE_OBJC_TRACEFILE_VERSION;
+   header.recordsize = sizeof( struct mulle_objc_traceevent);
+
+   if( fwrite( &header, sizeof( header), 1, fp) != 1)
+   {
+      fclose( fp);
+      errno = EIO;
+      return( -1);
+   }
+
+   universe->debug.tracefile.fp = fp;
+   return( 0);
+}
+
+
+//
+// The rings are not freed here, as other threads may still be writing to
+// them. They stay linked into the universe and are reused, if the tracefile
+// is opened again. _mulle_objc_universe_free_tracerings frees them, when
+// nobody can message anymore.
+//
+void   _mulle_objc_universe_close_tracefile( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_tracering   *ring;
+   FILE                           *fp;
+   uintptr_t                      dropped;
+
+   fp = universe->debug.tracefile.fp;
+   if( ! fp)
+      return;
+
+   dropped = 0;
+   mulle_thread_mutex_lock( &universe->debug.lock);
+   {
+      _mulle_objc_universe_flush_tracerings( universe);
+      universe->debug.tracefile.fp = NULL;
+
+      ring = _mulle_atomic_pointer_read( &universe->debug.tracefile.rings);
+      for( ; ring; ring = ring->next)
+         dropped += ring->dropped;
+   }
+   mulle_thread_mutex_unlock( &universe->debug.lock);
+
+   fclose( fp);
+
+   if( dropped)
+      fprintf( stderr, "mulle_objc_universe %p warning: %lu trace events "
+                       "were dropped, because the ring buffers were full\n",
+                       universe, (unsigned long) dropped);
+}
+
+
+void   _mulle_objc_universe_free_tracerings( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_tracering    *ring;
+   struct _mulle_objc_tracering    *next;
+   struct _mulle_objc_threadinfo   *config;
+
+   assert( ! universe->debug.tracefile.fp);
+
+   // our own thread may still reference its ring
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( config)
+      config->tracering = NULL;
+
+   ring = _mulle_atomic_pointer_read( &universe->debug.tracefile.rings);
+   _mulle_atomic_pointer_nonatomic_write( &universe->debug.tracefile.rings, NULL);
+
+   for( ; ring; ring = next)
+   {
+      next = ring->next;
+      mulle_allocator_free( &mulle_stdlib_allocator, ring);
+   }
+}
@@ -0,0 +1,102 @@
+//
+//  mulle-objc-tracering.h
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Nat! - Mulle kybernetiK.
+//  Copyright (c) 2020 Codeon GmbH.
+//  All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are met:
+//
+//  Redistributions of source code must retain the above copyright notice, this
+//  list of conditions and the following disclaimer.
+//
+//  Redistributions in binary form must reproduce the above copyright notice,
+//  this list of conditions and the following disclaimer in the documentation
+//  and/or other materials provided with the distribution.
+//
+//  Neither the name of Mulle kybernetiK nor the names of its contributors
+//  may be used to endorse or promote products derived from this software
+//  without specific prior written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+//  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+//  IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+//  ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+//  LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+//  CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+//  SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+//  INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+//  CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+//  ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+//  POSSIBILITY OF SUCH DAMAGE.
+//
+#ifndef mulle_objc_tracering_h__
+#define mulle_objc_tracering_h__
+
+#include "mulle-objc-atomicpointer.h"
+#include "mulle-objc-traceevent.h"
+
+#include "include.h"
+
+
+struct _mulle_objc_universe;
+
+//
+// Binary trace backend, enabled with MULLE_OBJC_TRACE_FILE=<filename>. The
+// method cache, class cache, method call and instance traces then write
+// fixed size records into a ring buffer of the calling thread, instead of
+// formatting text under the universe debug lock.
+//
+// Each ring has a single producer (its thread) and a single consumer (the
+// flush). The producer never waits, if the ring is full the event is
+// dropped and counted. After every half ring of events, the producer tries
+// to flush all rings, but only if nobody else is flushing already. The rings
+// are also flushed by mulle_objc_universe_flush_tracefile and when the
+// universe winds down.
+//
+// Use mulle-objc-tracedecode to print the file.
+//
+#ifndef MULLE_OBJC_TRACERING_SIZE
+# define MULLE_OBJC_TRACERING_SIZE   4096   // power of 2
+#endif
+
+
+struct _mulle_objc_tracering
+{
+   struct _mulle_objc_tracering   *next;
+   mulle_atomic_pointer_t         write;    // written by producer only
+   mulle_atomic_pointer_t         read;     // written by consumer only
+   uintptr_t                      threadnr;
+   uintptr_t                      dropped;
+   struct mulle_objc_traceevent   events[ MULLE_OBJC_TRACERING_SIZE];
+};
+
+
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_universe_trace_event( struct _mulle_objc_universe *universe,
+                                         enum mulle_objc_traceevent_type type,
+                                         uint32_t classid,
+                                         uint32_t methodid,
+                                         void *pointer);
+
+// returns -1 and errno on failure
+MULLE_C_NONNULL_FIRST_SECOND
+int    _mulle_objc_universe_open_tracefile( struct _mulle_objc_universe *universe,
+                                            char *filename);
+
+// flushes and closes, the rings are kept, as other threads may still be
+// writing to them
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_universe_close_tracefile( struct _mulle_objc_universe *universe);
+
+// frees all rings, only call this when no other thread can trace anymore
+MULLE_C_NONNULL_FIRST
+void   _mulle_objc_universe_free_tracerings( struct _mulle_objc_universe *universe);
+
+// writes out all pending events, can be called from any thread
+void   mulle_objc_universe_flush_tracefile( struct _mulle_objc_universe *universe);
+
+#endif
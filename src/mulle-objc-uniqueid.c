@@ -43,6 +43,56 @@
 #include "include-private.h"
 
 
+//
+// FNV-1a is a chain of xor/multiply steps over single bytes, so it can't be
+// vectorized without changing the result. What we can do, is to fetch eight
+// bytes with a single load and feed the steps from the register. This saves
+// the loads and most of the loop overhead, the output is the same as
+// _mulle_fnv1a_32.
+//
+#if defined( __BYTE_ORDER__) && defined( __ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+# define fnv1a_byte( word, i)   ((uint8_t) ((word) >> (56 - (i) * 8)))
+#else
+# define fnv1a_byte( word, i)   ((uint8_t) ((word) >> ((i) * 8)))
+#endif
+
+
+uint32_t   _mulle_objc_fnv1a_32( void *buf, size_t len)
+{
+   unsigned char   *s;
+   unsigned char   *sentinel;
+   uint64_t        word;
+   uint32_t        hash;
+
+   hash     = MULLE_FNV1A_32_INIT;
+   s        = buf;
+   sentinel = &s[ len & ~(size_t) 7];
+
+   while( s < sentinel)
+   {
+      memcpy( &word, s, sizeof( word));
+      s += sizeof( word);
+
+      hash = (hash ^ fnv1a_byte( word, 0)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 1)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 2)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 3)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 4)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 5)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 6)) * MULLE_FNV1A_32_PRIME;
+      hash = (hash ^ fnv1a_byte( word, 7)) * MULLE_FNV1A_32_PRIME;
+   }
+
+   sentinel = &s[ len & 7];
+   while( s < sentinel)
+      hash = (hash ^ *s++) * MULLE_FNV1A_32_PRIME;
+
+   return( hash);
+}
+
+#undef fnv1a_byte
+
+
 //
 // TODO: for certain special strings, we could use small numbers that
 //       produce smaller constants, which might save instruction space
@@ -66,7 +116,7 @@ mulle_objc_uniqueid_t   mulle_objc_uniqueid_from_string( char *s)
    }
 
 #if MULLE_OBJC_UNIQUEHASH_ALGORITHM == MULLE_OBJC_UNIQUEHASH_FNV1A
-   value = _mulle_fnv1a_32( s, len);
+   value = _mulle_objc_fnv1a_32( s, len);
 #else
 # error fnv not supported any longer
 #endif
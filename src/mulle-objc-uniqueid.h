@@ -38,6 +38,7 @@
 
 #include "include.h"
 
+#include <stddef.h>
 #include <stdint.h>
 #include <assert.h>
 #include <errno.h>
@@ -78,6 +79,9 @@ typedef uint32_t   mulle_objc_uniqueid_t;
 # endif
 #endif
 
+// same output as _mulle_fnv1a_32, but reads the input a word at a time
+uint32_t   _mulle_objc_fnv1a_32( void *buf, size_t len);
+
 mulle_objc_uniqueid_t  mulle_objc_uniqueid_from_string( char *s);
 
 static inline int  mulle_objc_uniqueid_is_sane( mulle_objc_uniqueid_t uniqueid)
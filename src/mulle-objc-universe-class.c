@@ -37,9 +37,13 @@
 
 #include "mulle-objc-class.h"
 #include "mulle-objc-infraclass.h"
+#include "mulle-objc-tracering.h"
 #include "mulle-objc-universe.h"
 #include "include-private.h"
 
+#include <errno.h>
+#include <string.h>
+
 
 int    mulle_objc_class_is_current_thread_registered( struct _mulle_objc_class *cls)
 {
@@ -65,6 +69,7 @@ static struct _mulle_objc_cacheentry *
                                                         struct _mulle_objc_class *cls)
 {
    mulle_objc_cache_uint_t         new_size;
+   mulle_objc_cache_uint_t         min_size;
    mulle_objc_classid_t            classid;
    struct _mulle_objc_cache        *old_cache;
    struct _mulle_objc_cacheentry   *entry;
@@ -77,6 +82,16 @@ static struct _mulle_objc_cacheentry *
    allocator = _mulle_objc_universe_get_allocator( universe);
    // a new beginning.. let it be filled anew
    new_size  = old_cache->size * 2;
+
+   //
+   // don't double our way up from the empty cache, one class at a time.
+   // The number of classes in the classtable is a good estimate of what
+   // will end up in the cache eventually.
+   //
+   min_size  = _mulle_objc_universe_get_cachesize_for_count( universe,
+                  (mulle_objc_cache_uint_t) mulle_concurrent_hashmap_count( &universe->classtable));
+   if( new_size < min_size)
+      new_size = min_size;
    cache     = mulle_objc_cache_new( new_size, allocator);
    if( ! cache)
       return( NULL);
@@ -93,15 +108,31 @@ static struct _mulle_objc_cacheentry *
 
    if( universe->debug.trace.class_cache)
    {
-      mulle_objc_universe_trace( universe,
-                                 "set new class cache %p with %u entries",
-                                 cache,
-                                 cache->size);
-      mulle_objc_universe_trace( universe,
-                                 "added class %08x \"%s\" to class cache %p",
-                                 _mulle_objc_class_get_classid( cls),
-                                 _mulle_objc_class_get_name( cls),
-                                 cache);
+      if( _mulle_objc_universe_has_tracefile( universe))
+      {
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_classcache_new,
+                                           MULLE_OBJC_NO_CLASSID,
+                                           0,
+                                           cache);
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_classcache_add,
+                                           _mulle_objc_class_get_classid( cls),
+                                           0,
+                                           cache);
+      }
+      else
+      {
+         mulle_objc_universe_trace( universe,
+                                    "set new class cache %p with %u entries",
+                                    cache,
+                                    cache->size);
+         mulle_objc_universe_trace( universe,
+                                    "added class %08x \"%s\" to class cache %p",
+                                    _mulle_objc_class_get_classid( cls),
+                                    _mulle_objc_class_get_name( cls),
+                                    cache);
+      }
    }
 
    if( &old_cache->entries[ 0] != &universe->empty_cache.entries[ 0])
@@ -130,10 +161,19 @@ static struct _mulle_objc_cacheentry *
       }
 
       if( universe->debug.trace.class_cache)
-         mulle_objc_universe_trace( universe,
-                                    "frees class cache %p with %u entries\n",
-                                    old_cache,
-                                    old_cache->size);
+      {
+         if( _mulle_objc_universe_has_tracefile( universe))
+            _mulle_objc_universe_trace_event( universe,
+                                              mulle_objc_traceevent_classcache_free,
+                                              MULLE_OBJC_NO_CLASSID,
+                                              0,
+                                              old_cache);
+         else
+            mulle_objc_universe_trace( universe,
+                                       "frees class cache %p with %u entries\n",
+                                       old_cache,
+                                       old_cache->size);
+      }
 
       _mulle_objc_cache_abafree( old_cache, allocator);
    }
@@ -175,12 +215,21 @@ MULLE_C_NONNULL_RETURN static struct _mulle_objc_cacheentry *
       {
          // trace here so we output the proper cache
          if( universe->debug.trace.class_cache)
-            mulle_objc_universe_trace( universe,
-                                       "added class %08x \"%s\" to "
-                                       "class cache %p\n",
-                                       _mulle_objc_infraclass_get_classid( infra),
-                                       _mulle_objc_infraclass_get_name( infra),
-                                       cache);
+         {
+            if( _mulle_objc_universe_has_tracefile( universe))
+               _mulle_objc_universe_trace_event( universe,
+                                                 mulle_objc_traceevent_classcache_add,
+                                                 _mulle_objc_infraclass_get_classid( infra),
+                                                 0,
+                                                 cache);
+            else
+               mulle_objc_universe_trace( universe,
+                                          "added class %08x \"%s\" to "
+                                          "class cache %p\n",
+                                          _mulle_objc_infraclass_get_classid( infra),
+                                          _mulle_objc_infraclass_get_name( infra),
+                                          cache);
+         }
          break;
       }
    }
@@ -208,29 +257,167 @@ static struct _mulle_objc_cacheentry   *
 
 void   _mulle_objc_universe_invalidate_classcache( struct _mulle_objc_universe *universe)
 {
-   struct _mulle_objc_cacheentry   *expect_entries;
    struct _mulle_objc_cacheentry   *old_entries;
    struct _mulle_objc_cache        *old_cache;
    struct mulle_allocator          *allocator;
 
-   old_entries = NULL;
-   do
+   //
+   // bump before the swap too, so that a rebuild, that enumerated the
+   // classtable before a class was removed, notices it, even if there is
+   // no cache to swap out yet (see _mulle_objc_universe_rebuild_classcache)
+   //
+   _mulle_atomic_pointer_increment( &universe->classgeneration);
+
+   old_cache = NULL;
+   for(;;)
    {
-      expect_entries = old_entries;
-      old_entries    = _mulle_objc_cachepivot_atomiccweakcas_entries( &universe->cachepivot,
-                                                                      universe->empty_cache.entries,
-                                                                      old_entries);
+      old_entries = _mulle_objc_cachepivot_atomicget_entries( &universe->cachepivot);
       if( old_entries == universe->empty_cache.entries)
-         return;
+         break;
+
+      if( ! _mulle_objc_cachepivot_atomiccas_entries( &universe->cachepivot,
+                                                      universe->empty_cache.entries,
+                                                      old_entries))
+      {
+         old_cache = _mulle_objc_cacheentry_get_cache_from_entries( old_entries);
+         break;
+      }
+   }
+
+   //
+   // thread class caches will be cleared on next use. Bump only after the
+   // swap, a lookup that still sees the old cache has then also read the
+   // old generation and its entry will be discarded
+   //
+   _mulle_atomic_pointer_increment( &universe->classgeneration);
+
+   if( old_cache)
+   {
+      allocator = _mulle_objc_universe_get_allocator( universe);
+      _mulle_objc_cache_abafree( old_cache, allocator);
    }
-   while( old_entries != expect_entries);
+}
+
+
+
+//
+// Build a new class cache with all classes of the classtable and publish it
+// with a single CAS. With "only_if_too_small" the current cache is kept, if
+// it is already large enough to hold all classes.
+//
+// A class removed during the enumeration could be in the new cache. The
+// CAS doesn't catch this, if the old cache is the empty cache, as then the
+// invalidation of the remover has nothing to swap. But the remover bumps
+// the classgeneration before it invalidates, so if it changed during the
+// rebuild, the new cache is not published or invalidated again.
+//
+static int
+   _mulle_objc_universe_rebuild_classcache( struct _mulle_objc_universe *universe,
+                                            int only_if_too_small)
+{
+   mulle_objc_cache_uint_t                     size;
+   struct _mulle_objc_cache                    *cache;
+   struct _mulle_objc_cache                    *old_cache;
+   struct _mulle_objc_infraclass               *infra;
+   struct mulle_allocator                      *allocator;
+   struct mulle_concurrent_hashmapenumerator   rover;
+   uintptr_t                                   generation;
 
    allocator = _mulle_objc_universe_get_allocator( universe);
-   old_cache = _mulle_objc_cacheentry_get_cache_from_entries( old_entries);
-   _mulle_objc_cache_abafree( old_cache, allocator);
+   for(;;)
+   {
+      generation = (uintptr_t) _mulle_atomic_pointer_read( &universe->classgeneration);
+      old_cache  = _mulle_objc_cachepivot_atomicget_cache( &universe->cachepivot);
+      size       = _mulle_objc_universe_get_cachesize_for_count( universe,
+                      (mulle_objc_cache_uint_t) mulle_concurrent_hashmap_count( &universe->classtable));
+      if( only_if_too_small && old_cache->size >= size)
+         return( 0);
+
+      cache = mulle_objc_cache_new( size, allocator);
+      if( ! cache)
+         return( -1);
+
+      //
+      // if classes are added concurrently, we might get more than we
+      // calculated, don't overfill then, the regular code will grow
+      //
+      rover = mulle_concurrent_hashmap_enumerate( &universe->classtable);
+      while( _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &infra))
+      {
+         if( _mulle_objc_universe_should_grow_cache( universe, cache))
+            break;
+         _mulle_objc_cache_inactivecache_add_pointer_entry( cache,
+                                                            infra,
+                                                            _mulle_objc_infraclass_get_classid( infra));
+      }
+      mulle_concurrent_hashmapenumerator_done( &rover);
+
+      if( generation != (uintptr_t) _mulle_atomic_pointer_read( &universe->classgeneration))
+      {
+         _mulle_objc_cache_free( cache, allocator);
+         continue;
+      }
+
+      if( _mulle_objc_cachepivot_atomiccas_entries( &universe->cachepivot,
+                                                    cache->entries,
+                                                    old_cache->entries))
+      {
+         _mulle_objc_cache_free( cache, allocator);
+         continue;
+      }
+
+      if( &old_cache->entries[ 0] != &universe->empty_cache.entries[ 0])
+         _mulle_objc_cache_abafree( old_cache, allocator);
+
+      // a class was removed between the check and the CAS, the cache is
+      // visible already, so it has to be invalidated
+      if( generation == (uintptr_t) _mulle_atomic_pointer_read( &universe->classgeneration))
+         break;
+      _mulle_objc_universe_invalidate_classcache( universe);
+   }
+
+   if( universe->debug.trace.class_cache)
+   {
+      if( _mulle_objc_universe_has_tracefile( universe))
+         _mulle_objc_universe_trace_event( universe,
+                                           mulle_objc_traceevent_classcache_new,
+                                           MULLE_OBJC_NO_CLASSID,
+                                           0,
+                                           cache);
+      else
+         mulle_objc_universe_trace( universe,
+                                    "set prefilled class cache %p with %u entries "
+                                    "for %lu classes",
+                                    cache,
+                                    cache->size,
+                                    (unsigned long) _mulle_atomic_pointer_read( &cache->n));
+   }
+
+   return( 0);
+}
+
+
+int   mulle_objc_universe_presize_classcache( struct _mulle_objc_universe *universe)
+{
+   if( ! universe)
+   {
+      errno = EINVAL;
+      return( -1);
+   }
+   return( _mulle_objc_universe_rebuild_classcache( universe, 1));
 }
 
 
+int   mulle_objc_universe_prefill_classcache( struct _mulle_objc_universe *universe)
+{
+   if( ! universe)
+   {
+      errno = EINVAL;
+      return( -1);
+   }
+   return( _mulle_objc_universe_rebuild_classcache( universe, 0));
+}
+
 
 MULLE_C_CONST_NONNULL_RETURN static struct _mulle_objc_cacheentry *
     _mulle_objc_universe_fill_classcache_nofail( struct _mulle_objc_universe *universe,
@@ -312,12 +499,27 @@ MULLE_C_NONNULL_RETURN struct _mulle_objc_infraclass *
 //
 #pragma mark - infraclass lookup, cached but no fast lookup
 
+//
+// with MULLE_OBJC_COUNT_CLASS_LOOKUP the classes, that are looked up
+// through the cache, are counted. The classes with the highest counts are the
+// candidates for the fastclasstable (see class-lookups.csv)
+//
+static inline struct _mulle_objc_infraclass  *
+   _mulle_objc_universe_count_infraclass_lookup( struct _mulle_objc_universe *universe,
+                                                 struct _mulle_objc_infraclass *infra)
+{
+   if( universe->debug.count.class_lookup && infra)
+      _mulle_atomic_pointer_increment( &infra->lookupcount);
+   return( infra);
+}
+
+
 //
 // will place class into cache, will not check for fastclass
 //
-struct _mulle_objc_infraclass  *
-    _mulle_objc_universe_lookup_infraclass_nofast( struct _mulle_objc_universe *universe,
-                                                   mulle_objc_classid_t classid)
+static struct _mulle_objc_infraclass  *
+    __mulle_objc_universe_lookup_infraclass_nofast( struct _mulle_objc_universe *universe,
+                                                    mulle_objc_classid_t classid)
 {
    struct _mulle_objc_cache        *cache;
    struct _mulle_objc_cacheentry   *entries;
@@ -335,7 +537,8 @@ struct _mulle_objc_infraclass  *
       offset  = offset & mask;
       entry   = (void *) &((char *) entries)[ offset];
       if( entry->key.uniqueid == classid)
-         return( _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer));
+         return( _mulle_objc_universe_count_infraclass_lookup( universe,
+                    _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer)));
 
       if( ! entry->key.uniqueid)
       {
@@ -343,7 +546,8 @@ struct _mulle_objc_infraclass  *
          if( ! entry)
             return( NULL);
 
-         return( _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer));
+         return( _mulle_objc_universe_count_infraclass_lookup( universe,
+                    _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer)));
       }
 
       offset += sizeof( struct _mulle_objc_cacheentry);
@@ -355,9 +559,9 @@ struct _mulle_objc_infraclass  *
 // class must exist, otherwise pain
 // will place class into cache, will not check for fastclass
 //
-MULLE_C_CONST_NONNULL_RETURN struct _mulle_objc_infraclass  *
-    _mulle_objc_universe_lookup_infraclass_nofail_nofast( struct _mulle_objc_universe *universe,
-                                                          mulle_objc_classid_t classid)
+MULLE_C_CONST_NONNULL_RETURN static struct _mulle_objc_infraclass  *
+    __mulle_objc_universe_lookup_infraclass_nofail_nofast( struct _mulle_objc_universe *universe,
+                                                           mulle_objc_classid_t classid)
 {
    struct _mulle_objc_cache        *cache;
    struct _mulle_objc_cacheentry   *entries;
@@ -375,7 +579,8 @@ MULLE_C_CONST_NONNULL_RETURN struct _mulle_objc_infraclass  *
       offset  = offset & mask;
       entry   = (void *) &((char *) entries)[ offset];
       if( entry->key.uniqueid == classid)
-         return( _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer));
+         return( _mulle_objc_universe_count_infraclass_lookup( universe,
+                    _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer)));
 
       if( entry->key.uniqueid)
       {
@@ -384,8 +589,89 @@ MULLE_C_CONST_NONNULL_RETURN struct _mulle_objc_infraclass  *
       }
 
       entry = _mulle_objc_universe_fill_classcache_nofail( universe, classid);
-      return( _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer));
+      return( _mulle_objc_universe_count_infraclass_lookup( universe,
+                 _mulle_atomic_pointer_nonatomic_read( &entry->value.pointer)));
+   }
+}
+
+
+#pragma mark - infraclass lookup, thread class cache
+
+//
+// The thread class cache sits in front of the universe class cache, so
+// that threads don't have to share the cache line of the universe class
+// cache. If the threadinfo is gone already (tss destructor), we just use
+// the universe class cache.
+//
+static struct _mulle_objc_threadclasscacheentry  *
+   _mulle_objc_universe_get_threadclasscacheentry( struct _mulle_objc_universe *universe,
+                                                   mulle_objc_classid_t classid)
+{
+   struct _mulle_objc_threadinfo         *config;
+   struct _mulle_objc_threadclasscache   *cache;
+   uintptr_t                             generation;
+
+   config = __mulle_objc_thread_get_threadinfo( universe);
+   if( ! config)
+      return( NULL);
+
+   cache      = &config->classcache;
+   generation = (uintptr_t) _mulle_atomic_pointer_read( &universe->classgeneration);
+   if( cache->generation != generation)
+   {
+      memset( cache->entries, 0, sizeof( cache->entries));
+      cache->generation = generation;
+   }
+
+   return( &cache->entries[ classid & (MULLE_OBJC_S_THREADCLASSCACHE - 1)]);
+}
+
+
+struct _mulle_objc_infraclass  *
+    _mulle_objc_universe_lookup_infraclass_nofast( struct _mulle_objc_universe *universe,
+                                                   mulle_objc_classid_t classid)
+{
+   struct _mulle_objc_threadclasscacheentry   *entry;
+   struct _mulle_objc_infraclass              *infra;
+
+   if( ! universe->config.thread_class_cache)
+      return( __mulle_objc_universe_lookup_infraclass_nofast( universe, classid));
+
+   entry = _mulle_objc_universe_get_threadclasscacheentry( universe, classid);
+   if( entry && entry->classid == classid)
+      return( _mulle_objc_universe_count_infraclass_lookup( universe, entry->infraclass));
+
+   infra = __mulle_objc_universe_lookup_infraclass_nofast( universe, classid);
+   if( entry && infra)
+   {
+      entry->classid    = classid;
+      entry->infraclass = infra;
+   }
+   return( infra);
+}
+
+
+MULLE_C_CONST_NONNULL_RETURN struct _mulle_objc_infraclass  *
+    _mulle_objc_universe_lookup_infraclass_nofail_nofast( struct _mulle_objc_universe *universe,
+                                                          mulle_objc_classid_t classid)
+{
+   struct _mulle_objc_threadclasscacheentry   *entry;
+   struct _mulle_objc_infraclass              *infra;
+
+   if( ! universe->config.thread_class_cache)
+      return( __mulle_objc_universe_lookup_infraclass_nofail_nofast( universe, classid));
+
+   entry = _mulle_objc_universe_get_threadclasscacheentry( universe, classid);
+   if( entry && entry->classid == classid)
+      return( _mulle_objc_universe_count_infraclass_lookup( universe, entry->infraclass));
+
+   infra = __mulle_objc_universe_lookup_infraclass_nofail_nofast( universe, classid);
+   if( entry)
+   {
+      entry->classid    = classid;
+      entry->infraclass = infra;
    }
+   return( infra);
 }
 
 
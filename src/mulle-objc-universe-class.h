@@ -258,6 +258,17 @@ MULLE_C_NONNULL_RETURN struct _mulle_objc_infraclass *
 // do not use, it's used by compat
 void    _mulle_objc_universe_invalidate_classcache( struct _mulle_objc_universe *universe);
 
+//
+// Call these after the bulk of the classes have been loaded (e.g. from the
+// Foundation before main). presize only replaces the class cache, if it is
+// too small to hold all the classes of the classtable. prefill always
+// publishes a new cache, prefilled with all classes. Both return -1 on
+// failure.
+//
+int   mulle_objc_universe_presize_classcache( struct _mulle_objc_universe *universe);
+
+int   mulle_objc_universe_prefill_classcache( struct _mulle_objc_universe *universe);
+
 
 MULLE_C_NONNULL_RETURN static inline struct _mulle_objc_infraclass *
    mulle_objc_object_lookup_infraclass_inline_nofail_nofast( void *obj,
@@ -37,6 +37,7 @@
 #define mulle_objc_universe_struct_h__
 
 #include "mulle-objc-cache.h"
+#include "mulle-objc-epoch.h"
 #include "mulle-objc-fastclasstable.h"
 #include "mulle-objc-fastmethodtable.h"
 #include "mulle-objc-ivarlist.h"
@@ -71,6 +72,9 @@ struct _mulle_objc_universeconfig
    unsigned   repopulate_caches        : 1;  // useful for coverage analysis
    unsigned   pedantic_exit            : 1;  // useful for leak checks
    unsigned   wait_threads_on_exit     : 1;  // useful for tests
+   unsigned   thread_class_cache       : 1;  // per thread class lookup cache
+   unsigned   adaptive_cache           : 1;  // grow on collisions, shrink when quiet
+   unsigned   epoch_gc                 : 1;  // epoch based reclamation instead of aba
    int        cache_fillrate;                // default is (0) can be 0-90
 };
 
@@ -140,12 +144,32 @@ struct _mulle_objc_universedebug
       unsigned   crash                  : 1;
    } warn;
 
+   struct
+   {
+      unsigned                 class_lookup   : 1;  // candidates for fastclasses
+      unsigned                 method_cache   : 1;  // hits per method cache entry
+      mulle_atomic_pointer_t   instance_alloc;      // per class instance accounting
+   } count;
+
+   struct
+   {
+      unsigned int             method_call;  // sample interval, 0 is off
+      mulle_atomic_pointer_t   buffers;      // struct _mulle_objc_profilebuffer
+   } profile;
+
+   struct
+   {
+      void                     *fp;          // FILE *, NULL is off
+      mulle_atomic_pointer_t   rings;        // struct _mulle_objc_tracering
+   } tracefile;
+
    struct
    {
       unsigned   universe_config         : 1;
       unsigned   print_origin            : 1; // set by default
       unsigned   stuck_class_coverage    : 1;
       unsigned   stuck_category_coverage : 1;
+      unsigned   uniqueid_audit          : 1;
    } print;
 };
 
@@ -234,7 +258,8 @@ struct _mulle_objc_universecallbacks
 // Garbage collection for the various caches
 struct _mulle_objc_garbagecollection
 {
-   struct mulle_aba   aba;
+   struct mulle_aba             aba;
+   struct _mulle_objc_epochgc   epoch;   // used instead of aba, if enabled
 };
 
 
@@ -300,6 +325,7 @@ struct _mulle_objc_memorymanagement
 struct _mulle_objc_taggedpointers
 {
    struct _mulle_objc_infraclass    *pointerclass[ 8];         // only 1 ... are really used
+   struct _mulle_objc_class         *pointerisa[ 8];           // same classes, for the branch free isa
 };
 
 
@@ -364,9 +390,15 @@ struct _mulle_objc_universe
    // unstable region, edit at will
 
    struct _mulle_objc_waitqueues            waitqueues;
+   struct mulle_concurrent_hashmap          signaturetable;  // parsed signatures
+   struct mulle_concurrent_hashmap          methodsignaturetable;  // methodid -> signatureinfo
+   struct mulle_concurrent_hashmap          signaturehashtable;  // methodid -> lenient hash
+   struct mulle_concurrent_hashmap          hashnametable;  // uniqueid -> name, from hashnames
 
    mulle_atomic_pointer_t                   retaincount_1;
    mulle_atomic_pointer_t                   cachecount_1; // #1#
+   mulle_atomic_pointer_t                   classgeneration; // #2#
+   mulle_atomic_pointer_t                   indexgeneration; // #3#
    mulle_atomic_pointer_t                   loadbits;
    mulle_atomic_pointer_t                   classindex;
    mulle_thread_mutex_t                     lock;
@@ -553,5 +585,14 @@ MULLE_C_NONNULL_RETURN static inline struct mulle_allocator *
 //      methodlist update and afterwards, and deduce if a costly cache flush
 //      is necessary.
 //
+// #2#: incremented before and after the class cache is invalidated. The per
+//      thread class caches compare it, before they are used. The class cache
+//      rebuild compares it, before it publishes a new cache.
+//
+// #3#: incremented, whenever an ivarlist, propertylist or protocolids are
+//      added to any class. The ivar, property and protocol indexes of the
+//      classes, which include the superclasses, are rebuilt, when it doesn't
+//      match.
+//
 
 #endif
@@ -45,8 +45,14 @@
 #include "mulle-objc-infraclass.h"
 #include "mulle-objc-metaclass.h"
 #include "mulle-objc-object.h"
+#include "mulle-objc-probe.h"
 #include "mulle-objc-signature.h"
+#include "mulle-objc-signatureinfo.h"
 #include "mulle-objc-csvdump.h"
+#include "mulle-objc-profile.h"
+#include "mulle-objc-profiledump.h"
+#include "mulle-objc-tracering.h"
+#include "mulle-objc-uniqueidaudit.h"
 #include "mulle-objc-walktypes.h"
 #include "include-private.h"
 #include <assert.h>
@@ -80,6 +86,12 @@ static void
 
    if( config->ignore_ivarhash_mismatch)
       fprintf( stderr, ", ignore ivarhash mismatch");
+   if( config->thread_class_cache)
+      fprintf( stderr, ", thread class cache");
+   if( config->adaptive_cache)
+      fprintf( stderr, ", adaptive cache");
+   if( config->epoch_gc)
+      fprintf( stderr, ", epoch gc");
    fprintf( stderr, ", min:-O%u max:-O%u", config->min_optlevel, config->max_optlevel);
    fprintf( stderr, ", cache fillrate: %u%%", config->cache_fillrate ? config->cache_fillrate : 25);
 }
@@ -300,6 +312,8 @@ void   mulle_objc_universe_fprintf( struct _mulle_objc_universe *universe,
 
 static void   _mulle_objc_universe_get_environment( struct _mulle_objc_universe  *universe)
 {
+   char   *s;
+
    universe->debug.warn.method_type  = mulle_objc_environment_get_int( "MULLE_OBJC_WARN_METHOD_TYPE",
                                                                         MULLE_OBJC_WARN_METHOD_TYPE_NORMAL,
                                                                         MULLE_OBJC_WARN_METHOD_TYPE_NONE,
@@ -346,6 +360,13 @@ static void   _mulle_objc_universe_get_environment( struct _mulle_objc_universe
    universe->debug.trace.timestamp       = getenv_yes_no( "MULLE_OBJC_TRACE_TIMESTAMP");
    universe->debug.trace.thread          = getenv_yes_no( "MULLE_OBJC_TRACE_THREAD");
 
+   s = getenv( "MULLE_OBJC_TRACE_FILE");
+   if( s && *s)
+   {
+      if( _mulle_objc_universe_open_tracefile( universe, s))
+         perror( "MULLE_OBJC_TRACE_FILE:");
+   }
+
    if( getenv_yes_no( "MULLE_OBJC_TRACE_CACHE"))
    {
       universe->debug.trace.method_cache  = 1;
@@ -374,8 +395,17 @@ static void   _mulle_objc_universe_get_environment( struct _mulle_objc_universe
       universe->debug.trace.tagged_pointer       = 1;
    }
 
+   universe->debug.count.class_lookup    = getenv_yes_no( "MULLE_OBJC_COUNT_CLASS_LOOKUP");
+   _mulle_atomic_pointer_nonatomic_write( &universe->debug.count.instance_alloc,
+                                          (void *) (intptr_t) getenv_yes_no( "MULLE_OBJC_COUNT_INSTANCE_ALLOC"));
+   universe->debug.count.method_cache    = getenv_yes_no( "MULLE_OBJC_COUNT_METHOD_CACHE");
+
+   universe->debug.profile.method_call   = mulle_objc_environment_get_int( "MULLE_OBJC_PROFILE_METHOD_CALL",
+                                                                          0, 0x100000, 0);
+
    universe->debug.print.print_origin    = getenv_yes_no_default( "MULLE_OBJC_PRINT_ORIGIN", 1);
    universe->debug.print.universe_config = getenv_yes_no( "MULLE_OBJC_PRINT_UNIVERSE_CONFIG");
+   universe->debug.print.uniqueid_audit  = getenv_yes_no( "MULLE_OBJC_PRINT_UNIQUEID_AUDIT");
 
    if( universe->debug.print.universe_config)
    {
@@ -576,8 +606,11 @@ static void   _mulle_objc_universe_set_defaults( struct _mulle_objc_universe  *u
    _mulle_concurrent_pointerarray_init( &universe->hashnames, 0, &universe->memory.allocator);
    _mulle_concurrent_pointerarray_init( &universe->gifts, 0, &universe->memory.allocator);
 
-   universe->path                = NULL;
-   universe->config.max_optlevel = 0x7;
+   universe->path                      = NULL;
+   universe->config.max_optlevel       = 0x7;
+   universe->config.thread_class_cache = getenv_yes_no( "MULLE_OBJC_THREAD_CLASS_CACHE");
+   universe->config.adaptive_cache     = getenv_yes_no( "MULLE_OBJC_ADAPTIVE_CACHE");
+   universe->config.epoch_gc           = getenv_yes_no( "MULLE_OBJC_EPOCH_GC");
 
    _mulle_objc_universe_get_environment( universe);
 
@@ -642,6 +675,10 @@ void   _mulle_objc_universe_init( struct _mulle_objc_universe *universe,
    _mulle_concurrent_hashmap_init( &universe->varyingsignaturedescriptortable, 8, allocator);
    _mulle_concurrent_hashmap_init( &universe->protocoltable, 64, allocator);
    _mulle_concurrent_hashmap_init( &universe->supertable, 256, allocator);
+   _mulle_concurrent_hashmap_init( &universe->signaturetable, 256, allocator);
+   _mulle_concurrent_hashmap_init( &universe->methodsignaturetable, 2048, allocator);
+   _mulle_concurrent_hashmap_init( &universe->signaturehashtable, 2048, allocator);
+   _mulle_concurrent_hashmap_init( &universe->hashnametable, 1024, allocator);
 
 
    _mulle_concurrent_hashmap_init( &universe->waitqueues.classestoload, 64, allocator);
@@ -839,6 +876,8 @@ void   _mulle_objc_universe_crunch( struct _mulle_objc_universe  *universe,
 
    // START OF LOCKED
 
+   MULLE_OBJC_PROBE1( universe__crunch__start, universe);
+
    if( trace)
       mulle_objc_universe_trace( universe,
                                  "[%p] crunch of the universe is in progress",
@@ -851,6 +890,8 @@ void   _mulle_objc_universe_crunch( struct _mulle_objc_universe  *universe,
    callback = universe->callbacks.did_crunch;
    (*crunch)( universe);
 
+   MULLE_OBJC_PROBE1( universe__crunch__done, universe);
+
    if( trace)
       mulle_objc_universe_trace( universe,
                                  "[%p] crunch of the universe is done",
@@ -1105,6 +1146,7 @@ int  _mulle_objc_universe_set_taggedpointerclass_at_index( struct _mulle_objc_un
                                  _mulle_objc_infraclass_get_name( infra));
 
    universe->taggedpointers.pointerclass[ index] = infra;
+   universe->taggedpointers.pointerisa[ index]   = _mulle_objc_infraclass_as_class( infra);
 
    _mulle_objc_universe_set_loadbit( universe, MULLE_OBJC_UNIVERSE_HAVE_TPS_CLASSES);
 
@@ -1499,6 +1541,11 @@ static void
    _mulle_concurrent_hashmap_done( &universe->waitqueues.categoriestoload);
    _mulle_concurrent_hashmap_done( &universe->waitqueues.classestoload);
    _mulle_concurrent_hashmap_done( &universe->supertable);
+   _mulle_objc_universe_free_signatureinfos( universe);
+   _mulle_concurrent_hashmap_done( &universe->signaturetable);
+   _mulle_concurrent_hashmap_done( &universe->methodsignaturetable);
+   _mulle_concurrent_hashmap_done( &universe->signaturehashtable);
+   _mulle_concurrent_hashmap_done( &universe->hashnametable);
    _mulle_concurrent_hashmap_done( &universe->protocoltable);
    _mulle_concurrent_hashmap_done( &universe->descriptortable);
    _mulle_concurrent_hashmap_done( &universe->varyingsignaturedescriptortable);
@@ -1561,6 +1608,23 @@ void   _mulle_objc_universe_done( struct _mulle_objc_universe *universe)
    if( universe->debug.warn.stuck_loadable)
       _mulle_objc_universe_check_waitqueues( universe);
 
+#ifdef MULLE_OBJC_DEBUG_SUPPORT
+   if( universe->debug.count.class_lookup)
+      mulle_objc_universe_csvdump_classlookups_to_filename( universe, "class-lookups.csv");
+   if( _mulle_atomic_pointer_read( &universe->debug.count.instance_alloc))
+      mulle_objc_universe_csvdump_instanceallocs_to_filename( universe, "instance-allocs.csv");
+   if( universe->debug.count.method_cache)
+      mulle_objc_universe_csvdump_cacheheatmap_to_filename( universe, "method-cache-heatmap.csv");
+   if( universe->debug.print.uniqueid_audit)
+      mulle_objc_universe_audit_uniqueids_to_fp( universe, stderr);
+   if( universe->debug.profile.method_call)
+      mulle_objc_universe_profiledump_to_filename( universe, "method-calls.folded");
+#endif
+   // other threads may still write into the profile buffers and trace rings
+   // so they are freed later
+   universe->debug.profile.method_call = 0;
+   _mulle_objc_universe_close_tracefile( universe);
+
    // the friends are freed first, and everything is still fairly fine
    // you can still message around
 
@@ -1683,6 +1747,10 @@ void   _mulle_objc_universe_done( struct _mulle_objc_universe *universe)
    if( universe->debug.trace.universe)
       mulle_objc_universe_trace( universe, "deallocing threadlocal");
 
+   // now no other thread can still write into a buffer or a ring
+   _mulle_objc_universe_free_profilebuffers( universe);
+   _mulle_objc_universe_free_tracerings( universe);
+
    mulle_objc_thread_unset_threadinfo( universe);
    mulle_thread_tss_free( universe->threadkey);
 
@@ -1775,6 +1843,18 @@ static void   _mulle_objc_universe_init_gc( struct _mulle_objc_universe *univers
    allocator = _mulle_objc_universe_get_allocator( universe);
    if( _mulle_aba_init( &universe->garbage.aba, allocator))
       mulle_objc_universe_fail_perror( universe, "_mulle_aba_init");
+
+   if( ! universe->config.epoch_gc)
+      return;
+
+   if( _mulle_objc_epochgc_init( &universe->garbage.epoch))
+      mulle_objc_universe_fail_perror( universe, "_mulle_objc_epochgc_init");
+
+   allocator->aba     = &universe->garbage.epoch;
+   allocator->abafree = _mulle_objc_epochgc_abafree;
+
+   if( universe->debug.trace.universe)
+      mulle_objc_universe_trace( universe, "use epoch gc");
 }
 
 
@@ -1787,6 +1867,7 @@ static void   _mulle_objc_universe_done_gc( struct _mulle_objc_universe *univers
       mulle_objc_universe_fail_perror( universe, "_mulle_aba_unregister_current_thread");
 
    _mulle_aba_done( &gc->aba);
+   _mulle_objc_epochgc_done( &gc->epoch);
 }
 
 
@@ -1799,6 +1880,10 @@ void   _mulle_objc_thread_register_universe_gc( struct _mulle_objc_universe *uni
    gc = _mulle_objc_universe_get_gc( universe);
    if( _mulle_aba_register_current_thread( &gc->aba))
       mulle_objc_universe_fail_perror( universe, "_mulle_aba_register_current_thread");
+
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      if( _mulle_objc_epochgc_register_current_thread( &gc->epoch))
+         mulle_objc_universe_fail_perror( universe, "_mulle_objc_epochgc_register_current_thread");
 }
 
 
@@ -1821,11 +1906,13 @@ void   _mulle_objc_thread_register_universe_gc_if_needed( struct _mulle_objc_uni
 //   assert( _mulle_objc_universe_is_initialized( universe));
 
    gc = _mulle_objc_universe_get_gc( universe);
-   if( _mulle_aba_is_current_thread_registered( &gc->aba))
-      return;
+   if( ! _mulle_aba_is_current_thread_registered( &gc->aba))
+      if( _mulle_aba_register_current_thread( &gc->aba))
+         mulle_objc_universe_fail_perror( universe, "_mulle_aba_register_current_thread");
 
-   if( _mulle_aba_register_current_thread( &gc->aba))
-      mulle_objc_universe_fail_perror( universe, "_mulle_aba_register_current_thread");
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      if( _mulle_objc_epochgc_register_current_thread( &gc->epoch))
+         mulle_objc_universe_fail_perror( universe, "_mulle_objc_epochgc_register_current_thread");
 }
 
 
@@ -1836,6 +1923,9 @@ void   _mulle_objc_thread_remove_universe_gc( struct _mulle_objc_universe *unive
    assert( _mulle_objc_universe_is_messaging( universe));
 
    gc = _mulle_objc_universe_get_gc( universe);
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      _mulle_objc_epochgc_unregister_current_thread( &gc->epoch);
+
    if( _mulle_aba_unregister_current_thread( &gc->aba))
       mulle_objc_universe_fail_perror( universe, "_mulle_aba_unregister_current_thread");
 }
@@ -1848,11 +1938,87 @@ void   _mulle_objc_thread_checkin_universe_gc( struct _mulle_objc_universe *univ
    assert( _mulle_objc_universe_is_messaging( universe));
 
    gc = _mulle_objc_universe_get_gc( universe);
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      _mulle_objc_epochgc_checkin_current_thread( &gc->epoch);
+
    if( _mulle_aba_checkin_current_thread( &gc->aba))
       mulle_objc_universe_fail_perror( universe, "_mulle_aba_checkin_current_thread");
 }
 
 
+void   _mulle_objc_thread_enter_quiescence_universe_gc( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   assert( _mulle_objc_universe_is_messaging( universe));
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      _mulle_objc_epochgc_enter_quiescence( &gc->epoch);
+}
+
+
+void   _mulle_objc_thread_leave_quiescence_universe_gc( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   assert( _mulle_objc_universe_is_messaging( universe));
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   if( _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      _mulle_objc_epochgc_leave_quiescence( &gc->epoch);
+}
+
+
+int   _mulle_objc_thread_is_quiescent_universe_gc( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   if( ! _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      return( 0);
+   return( _mulle_objc_epochgc_is_current_thread_quiescent( &gc->epoch));
+}
+
+
+size_t   mulle_objc_universe_reclaim_epochgc( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   if( ! universe)
+      return( 0);
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   if( ! _mulle_objc_epochgc_is_enabled( &gc->epoch))
+      return( 0);
+   return( _mulle_objc_epochgc_reclaim( &gc->epoch));
+}
+
+
+size_t   mulle_objc_universe_get_bytes_pending_reclamation( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   if( ! universe)
+      return( 0);
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   return( _mulle_objc_epochgc_get_pending_bytes( &gc->epoch));
+}
+
+
+size_t   mulle_objc_universe_get_count_pending_reclamation( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_garbagecollection   *gc;
+
+   if( ! universe)
+      return( 0);
+
+   gc = _mulle_objc_universe_get_gc( universe);
+   return( _mulle_objc_epochgc_get_pending_count( &gc->epoch));
+}
+
+
 
 # pragma mark - "classes"
 
@@ -2129,7 +2295,7 @@ int   mulle_objc_universe_remove_infraclass( struct _mulle_objc_universe *univer
 
    // remove from fastclass table
    index = mulle_objc_get_fastclasstable_index( _mulle_objc_infraclass_get_classid( infra));
-   if( index > 0)
+   if( index >= 0)
       _mulle_objc_universe_remove_fastclass_at_index( universe, index);
 
    return( 0);
@@ -2183,6 +2349,17 @@ void   _mulle_objc_universe_set_fastclass( struct _mulle_objc_universe *universe
 
 # pragma mark - cache
 
+static inline int   _mulle_objc_universe_is_cache_overfilled( struct _mulle_objc_universe *universe,
+                                                                size_t used,
+                                                                size_t size)
+{
+   if( ! universe->config.cache_fillrate)
+      return( used * 3 >= size);  // have cache filled to a third
+
+   return( used * 100 >= size * universe->config.cache_fillrate);
+}
+
+
 int   _mulle_objc_universe_should_grow_cache( struct _mulle_objc_universe *universe,
                                               struct _mulle_objc_cache *cache)
 {
@@ -2192,15 +2369,81 @@ int   _mulle_objc_universe_should_grow_cache( struct _mulle_objc_universe *unive
    used = (size_t) _mulle_atomic_pointer_read( &cache->n);
    size = cache->size;
 
-   if( ! universe->config.cache_fillrate)
-      return( used * 3 >= size);  // have cache filled to a third
+   //
+   // With the adaptive policy, a cache that is a quarter full but where
+   // entries on average already land more than one slot away from their
+   // home slot, is grown early.
+   //
+   if( universe->config.adaptive_cache && used * 4 >= size)
+      if( (size_t) _mulle_objc_cache_get_probes( cache) > used)
+         return( 1);
 
-   return( used * 100 >= size * universe->config.cache_fillrate);
+   return( _mulle_objc_universe_is_cache_overfilled( universe, used, size));
+}
+
+
+//
+// the smallest cache size, that can hold n entries without being grown
+//
+mulle_objc_cache_uint_t
+   _mulle_objc_universe_get_cachesize_for_count( struct _mulle_objc_universe *universe,
+                                                 mulle_objc_cache_uint_t n)
+{
+   mulle_objc_cache_uint_t   size;
+
+   size = MULLE_OBJC_MIN_CACHE_SIZE;
+   while( _mulle_objc_universe_is_cache_overfilled( universe, n, size))
+      size <<= 1;
+   return( size);
 }
 
 
 # pragma mark - method descriptors
 
+//
+// the lenient hash is stored as a pointer value, so keep it clear of
+// NULL and MULLE_CONCURRENT_INVALID_POINTER
+//
+static void   *
+   _mulle_objc_descriptor_get_lenienthash_value( struct _mulle_objc_descriptor *p)
+{
+   uintptr_t   hash;
+
+   hash = _mulle_objc_signature_get_lenienthash( p->signature);
+   if( ! hash || (void *) hash == MULLE_CONCURRENT_INVALID_POINTER)
+      hash = 0x1848;
+   return( (void *) hash);
+}
+
+
+//
+// For the lenient compare, the hash of the signature of the first
+// descriptor is remembered. Duplicates then just compute their own hash.
+// Lenient equal signatures have the same hash, so a mismatch rejects
+// without a full compare. A match is taken as equal.
+// The NORMAL and STRICT compares are plain string compares, which are
+// cheaper than computing the hash, so they don't use it.
+//
+static int
+   _mulle_objc_universe_compare_descriptor_lenient( struct _mulle_objc_universe *universe,
+                                                    struct _mulle_objc_descriptor *dup,
+                                                    struct _mulle_objc_descriptor *p)
+{
+   void   *dup_hash;
+   void   *p_hash;
+
+   p_hash   = _mulle_objc_descriptor_get_lenienthash_value( p);
+   dup_hash = _mulle_concurrent_hashmap_lookup( &universe->signaturehashtable, dup->methodid);
+   if( ! dup_hash)
+   {
+      dup_hash = _mulle_objc_descriptor_get_lenienthash_value( dup);
+      _mulle_concurrent_hashmap_register( &universe->signaturehashtable, dup->methodid, dup_hash);
+   }
+
+   return( p_hash == dup_hash ? 0 : 1);
+}
+
+
 static struct _mulle_objc_descriptor *
    _mulle_objc_universe_register_descriptor( struct _mulle_objc_universe *universe,
                                              struct _mulle_objc_descriptor *p)
@@ -2227,6 +2470,7 @@ static struct _mulle_objc_descriptor *
    dup = _mulle_concurrent_hashmap_register( &universe->descriptortable, p->methodid, p);
    if( ! dup)
    {
+      MULLE_OBJC_PROBE3( descriptor__add, p, p->methodid, p->name);
       if( universe->debug.trace.descriptor_add)
          mulle_objc_universe_trace( universe,
                                     "add descriptor %08x \"%s\" (%p)",
@@ -2242,6 +2486,10 @@ static struct _mulle_objc_descriptor *
 
    assert( p->methodid == dup->methodid);
 
+   // same descriptor or signature string shared by the linker
+   if( dup->signature == p->signature && dup->name == p->name)
+      return( dup);
+
    // hash clash is very bad
    if( strcmp( dup->name, p->name))
       mulle_objc_universe_fail_generic( universe,
@@ -2254,7 +2502,7 @@ static struct _mulle_objc_descriptor *
       comparison = 0;
       break;
    case MULLE_OBJC_WARN_METHOD_TYPE_LENIENT :
-      comparison = _mulle_objc_signature_compare_lenient( dup->signature, p->signature);
+      comparison = _mulle_objc_universe_compare_descriptor_lenient( universe, dup, p);
       break;
    case MULLE_OBJC_WARN_METHOD_TYPE_NORMAL :
       comparison = _mulle_objc_signature_compare( dup->signature, p->signature);
@@ -2698,31 +2946,38 @@ void  _mulle_objc_universe_set_staticstringclass( struct _mulle_objc_universe *u
 
 # pragma mark - hashnames (debug output only)
 
+//
+// The lists are kept for enumeration, lookups go through the hashnametable.
+// If the same uniqueid appears in multiple lists, the first one added wins,
+// as it did with the list search before.
+//
 void   _mulle_objc_universe_add_loadhashedstringlist( struct _mulle_objc_universe *universe,
                                                       struct _mulle_objc_loadhashedstringlist *hashnames)
 {
+   struct _mulle_objc_loadhashedstring   *p;
+   struct _mulle_objc_loadhashedstring   *sentinel;
+
    _mulle_concurrent_pointerarray_add( &universe->hashnames, (void *) hashnames);
+
+   p        = hashnames->loadentries;
+   sentinel = &p[ hashnames->n_loadentries];
+   for( ; p < sentinel; p++)
+   {
+      if( ! mulle_objc_uniqueid_is_sane( p->uniqueid) || ! p->string)
+         continue;
+      _mulle_concurrent_hashmap_insert( &universe->hashnametable,
+                                        p->uniqueid,
+                                        p->string);
+   }
 }
 
 
 char  *_mulle_objc_universe_search_hashstring( struct _mulle_objc_universe *universe,
                                                mulle_objc_uniqueid_t hash)
 {
-   struct mulle_concurrent_pointerarrayenumerator   rover;
-   struct _mulle_objc_loadhashedstringlist          *map;
-   char                                             *s;
-
-   s     = NULL;
-   rover = mulle_concurrent_pointerarray_enumerate( &universe->hashnames);
-   while( map = _mulle_concurrent_pointerarrayenumerator_next( &rover))
-   {
-      s = mulle_objc_loadhashedstringlist_bsearch( map, hash);
-      if( s)
-         break;
-   }
-   mulle_concurrent_pointerarrayenumerator_done( &rover);
-
-   return( s);
+   if( ! mulle_objc_uniqueid_is_sane( hash))
+      return( NULL);
+   return( _mulle_concurrent_hashmap_lookup( &universe->hashnametable, hash));
 }
 
 
@@ -2885,13 +3140,8 @@ static int   mulle_objc_infraclass_is_subclass( struct _mulle_objc_infraclass *i
    if( ! kindofcls)
       return( 1);
 
-   while( infra)
-   {
-      if( infra == kindofcls)
-         return( 1);
-      infra = _mulle_objc_infraclass_get_superclass( infra);
-   }
-   return( 0);
+   return( _mulle_objc_class_is_subclass_of_class( _mulle_objc_infraclass_as_class( infra),
+                                                   _mulle_objc_infraclass_as_class( kindofcls)));
 }
 
 
@@ -2929,3 +3179,29 @@ void  _mulle_objc_universe_invalidate_classcaches( struct _mulle_objc_universe *
 }
 
 
+static mulle_objc_walkcommand_t
+      shrink_methodcaches_callback( struct _mulle_objc_universe *universe,
+                                    void *p,
+                                    enum mulle_objc_walkpointertype_t type,
+                                    char *key,
+                                    void *parent,
+                                    void *userinfo)
+{
+   unsigned int   *n = userinfo;
+
+   *n += _mulle_objc_class_shrink_methodcache( p);
+   return( mulle_objc_walk_ok);
+}
+
+
+unsigned int   _mulle_objc_universe_shrink_methodcaches( struct _mulle_objc_universe *universe)
+{
+   unsigned int   n;
+
+   n = 0;
+   if( universe->config.adaptive_cache)
+      _mulle_objc_universe_walk_classes( universe, 1, shrink_methodcaches_callback, &n);
+   return( n);
+}
+
+
@@ -118,6 +118,29 @@ struct _mulle_objc_exceptionstackentry;
 
 typedef void   mulle_objc_threadinfo_destructor_t( struct _mulle_objc_threadinfo *, void *);
 
+
+//
+// A small direct mapped class cache per thread, used if the universe is
+// configured with `thread_class_cache`. It's only touched by its own thread,
+// so no atomics needed. It is cleared, when the classgeneration of the
+// universe changes.
+//
+#define MULLE_OBJC_S_THREADCLASSCACHE   16
+
+struct _mulle_objc_threadclasscacheentry
+{
+   mulle_objc_classid_t            classid;
+   struct _mulle_objc_infraclass   *infraclass;
+};
+
+
+struct _mulle_objc_threadclasscache
+{
+   uintptr_t                                  generation;
+   struct _mulle_objc_threadclasscacheentry   entries[ MULLE_OBJC_S_THREADCLASSCACHE];
+};
+
+
 struct _mulle_objc_threadinfo
 {
    struct _mulle_objc_universe              *universe;
@@ -125,6 +148,7 @@ struct _mulle_objc_threadinfo
    uintptr_t                                nr;  // thread identifier short
    struct _mulle_objc_exceptionstackentry   *exception_stack;
    struct mulle_allocator                   *allocator;
+   struct _mulle_objc_threadclasscache      classcache;
 
    // these will be called when mulle_objc_thread_unset_threadinfo is called
    // (or the thread dies)
@@ -133,6 +157,9 @@ struct _mulle_objc_threadinfo
 
    mulle_objc_threadinfo_destructor_t      *userspace_destructor;
    intptr_t                                userspace[ S_MULLE_OBJC_THREADCONFIG_USER_SPACE / sizeof( intptr_t)];
+
+   struct _mulle_objc_profilebuffer        *profilebuffer;  // owned by universe
+   struct _mulle_objc_tracering            *tracering;      // owned by universe
 };
 
 static inline struct _mulle_objc_universe *
@@ -513,6 +540,27 @@ void   _mulle_objc_thread_register_universe_gc_if_needed( struct _mulle_objc_uni
 void   _mulle_objc_thread_register_universe_gc( struct _mulle_objc_universe *universe);
 void   _mulle_objc_thread_remove_universe_gc( struct _mulle_objc_universe *universe);
 
+//
+// With MULLE_OBJC_EPOCH_GC, a thread that is about to block (e.g. in I/O)
+// should enter quiescence, so that it doesn't hold back the reclamation of
+// memory. It must not access the runtime, until it has left quiescence or
+// checked in. In DEBUG builds, a method cache miss of a quiescent thread
+// fails the universe. Without the epoch gc, these do nothing.
+//
+void   _mulle_objc_thread_enter_quiescence_universe_gc( struct _mulle_objc_universe *universe);
+void   _mulle_objc_thread_leave_quiescence_universe_gc( struct _mulle_objc_universe *universe);
+int    _mulle_objc_thread_is_quiescent_universe_gc( struct _mulle_objc_universe *universe);
+
+// can be called periodically from a background thread, returns bytes freed
+size_t   mulle_objc_universe_reclaim_epochgc( struct _mulle_objc_universe *universe);
+
+//
+// memory retired with the epoch gc, that has not been freed yet. The
+// bytes only include blocks of known size, like method caches
+//
+size_t   mulle_objc_universe_get_bytes_pending_reclamation( struct _mulle_objc_universe *universe);
+size_t   mulle_objc_universe_get_count_pending_reclamation( struct _mulle_objc_universe *universe);
+
 
 #pragma mark - ObjC thread support
 
@@ -612,6 +660,26 @@ void  _mulle_objc_universe_set_fastclass( struct _mulle_objc_universe *universe,
 
 #pragma mark - method cache
 
+//
+// when method calls are traced, methods aren't cached, so that each call
+// goes through the slow path. Profiling keeps the caches and samples in
+// the instrumented cache lookups instead.
+//
+static inline int
+   _mulle_objc_universe_should_cache_methods( struct _mulle_objc_universe *universe)
+{
+   return( ! universe->debug.trace.method_call);
+}
+
+
+// traces go into the binary ring buffers (see mulle-objc-tracering.h)
+static inline int
+   _mulle_objc_universe_has_tracefile( struct _mulle_objc_universe *universe)
+{
+   return( universe->debug.tracefile.fp != NULL);
+}
+
+
 static inline unsigned int
    _mulle_objc_universe_get_numberofpreloadmethods( struct _mulle_objc_universe *universe)
 {
@@ -622,6 +690,10 @@ static inline unsigned int
 int  _mulle_objc_universe_should_grow_cache( struct _mulle_objc_universe *universe,
                                              struct _mulle_objc_cache *cache);
 
+mulle_objc_cache_uint_t
+   _mulle_objc_universe_get_cachesize_for_count( struct _mulle_objc_universe *universe,
+                                                 mulle_objc_cache_uint_t n);
+
 
 #pragma mark - methods
 
@@ -984,6 +1056,17 @@ static inline void   mulle_objc_invalidate_classcaches( mulle_objc_universeid_t
 }
 
 
+//
+// Only does something with the "adaptive_cache" config. Call this
+// periodically in quiet periods (e.g. when a runloop is idle). Method caches
+// that are less than a quarter full are halved, keeping their entries, so
+// that memory of caches that grew during a busy phase is given back.
+// Returns the number of caches shrunk.
+//
+MULLE_C_NONNULL_FIRST
+unsigned int   _mulle_objc_universe_shrink_methodcaches( struct _mulle_objc_universe *universe);
+
+
 # pragma mark - garbage collection
 
 static inline void   mulle_objc_thread_register( mulle_objc_universeid_t universeid)
@@ -1013,6 +1096,24 @@ static inline void   mulle_objc_thread_checkin( mulle_objc_universeid_t universe
 }
 
 
+static inline void   mulle_objc_thread_enter_quiescence( mulle_objc_universeid_t universeid)
+{
+   struct _mulle_objc_universe   *universe;
+
+   universe = mulle_objc_global_get_universe_inline( universeid);
+   _mulle_objc_thread_enter_quiescence_universe_gc( universe);
+}
+
+
+static inline void   mulle_objc_thread_leave_quiescence( mulle_objc_universeid_t universeid)
+{
+   struct _mulle_objc_universe   *universe;
+
+   universe = mulle_objc_global_get_universe_inline( universeid);
+   _mulle_objc_thread_leave_quiescence_universe_gc( universe);
+}
+
+
 MULLE_C_NONNULL_FIRST
 static inline struct _mulle_objc_threadinfo  *
    __mulle_objc_thread_get_threadinfo( struct _mulle_objc_universe *universe)
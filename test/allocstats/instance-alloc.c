@@ -0,0 +1,129 @@
+//
+//  instance-alloc.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Built with MULLE_OBJC_ALLOCSTATS, allocations and frees of each class are
+// counted separately, but only while accounting is turned on. Frees of
+// instances that were allocated before do not make live negative.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+#define MULLE_OBJC_ALLOCSTATS
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+#define ___Bar_classid   MULLE_OBJC_CLASSID( 0xbbc7dbad)
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_class( struct _mulle_objc_universe *universe,
+              mulle_objc_classid_t classid,
+              char *name)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, classid, name, 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+static void   print( char *label, struct _mulle_objc_infraclass *infra)
+{
+   struct mulle_objc_allocstatsinfo   info;
+   size_t                             size;
+
+   mulle_objc_infraclass_get_allocstatsinfo( infra, &info);
+   size = _mulle_objc_infraclass_get_allocationsize( infra);
+   printf( "%s %s: live=%lu allocs=%lu frees=%lu peak=%lu bytes %s\n",
+           label,
+           _mulle_objc_infraclass_get_name( infra),
+           (unsigned long) info.live,
+           (unsigned long) info.allocs,
+           (unsigned long) info.frees,
+           (unsigned long) info.peak,
+           info.bytes == info.allocs * size ? "ok" : "FAIL");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   struct _mulle_objc_infraclass   *bar;
+   void                            *foos[ 10];
+   void                            *bars[ 3];
+   void                            *early;
+   unsigned int                    i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   foo      = new_class( universe, ___Foo_classid, "Foo");
+   bar      = new_class( universe, ___Bar_classid, "Bar");
+
+   // not counted
+   early = _mulle_objc_infraclass_alloc_instance( foo);
+   print( "off", foo);
+
+   mulle_objc_universe_set_count_instance_alloc( universe, 1);
+
+   for( i = 0; i < 10; i++)
+      foos[ i] = _mulle_objc_infraclass_alloc_instance( foo);
+   for( i = 0; i < 3; i++)
+      bars[ i] = _mulle_objc_infraclass_alloc_instance( bar);
+   print( "alloc", foo);
+   print( "alloc", bar);
+
+   for( i = 0; i < 4; i++)
+      _mulle_objc_instance_free( foos[ i]);
+   _mulle_objc_instance_free( bars[ 0]);
+   print( "free", foo);
+   print( "free", bar);
+
+   // frees more than were counted
+   for( ; i < 10; i++)
+      _mulle_objc_instance_free( foos[ i]);
+   _mulle_objc_instance_free( early);
+   print( "early", foo);
+
+   mulle_objc_universe_set_count_instance_alloc( universe, 0);
+
+   for( i = 1; i < 3; i++)
+      _mulle_objc_instance_free( bars[ i]);
+   print( "stopped", bar);
+
+   return( 0);
+}
@@ -0,0 +1,141 @@
+//
+//  invalidate.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Two classes "Foo" with the same classid are swapped in and out of the
+// universe, while another thread looks "Foo" up through its thread class
+// cache. After each swap the lookup thread must find the current class,
+// a stale class kept in its thread class cache would be a dangling pointer
+// in real life.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define N_ROUNDS         2000
+
+
+static mulle_atomic_pointer_t   current;   // the class in the universe
+static mulle_atomic_pointer_t   round_nr;  // bumped by writer after a swap
+static mulle_atomic_pointer_t   checked;   // round the reader verified
+static mulle_atomic_pointer_t   failures;
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+   {
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+      universe->config.thread_class_cache = 1;
+   }
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   return( infra);
+}
+
+
+static mulle_thread_rval_t   lookup( void *arg)
+{
+   struct _mulle_objc_universe     *universe = arg;
+   struct _mulle_objc_infraclass   *infra;
+   uintptr_t                       nr;
+
+   mulle_objc_thread_setup_threadinfo( universe);
+   _mulle_objc_thread_register_universe_gc( universe);
+
+   for(;;)
+   {
+      nr    = (uintptr_t) _mulle_atomic_pointer_read( &round_nr);
+      infra = _mulle_objc_universe_lookup_infraclass_nofast( universe, ___Foo_classid);
+
+      // writer is waiting for us to check this round
+      if( nr != (uintptr_t) _mulle_atomic_pointer_read( &checked))
+      {
+         if( infra != _mulle_atomic_pointer_read( &current))
+            _mulle_atomic_pointer_increment( &failures);
+         _mulle_atomic_pointer_write( &checked, (void *) nr);
+         if( nr == N_ROUNDS)
+            break;
+      }
+   }
+
+   _mulle_objc_thread_remove_universe_gc( universe);
+   mulle_objc_thread_unset_threadinfo( universe);
+   return( 0);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo[ 2];
+   mulle_thread_t                  thread;
+   uintptr_t                       i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   foo[ 0] = new_foo( universe);
+   foo[ 1] = new_foo( universe);
+
+   mulle_objc_universe_add_infraclass_nofail( universe, foo[ 0]);
+   _mulle_atomic_pointer_write( &current, foo[ 0]);
+
+   if( mulle_thread_create( lookup, universe, &thread))
+      return( 1);
+
+   for( i = 1; i <= N_ROUNDS; i++)
+   {
+      // let the reader race the swap
+      mulle_thread_yield();
+
+      if( mulle_objc_universe_remove_infraclass( universe, foo[ (i - 1) & 1]))
+         return( 1);
+      _mulle_atomic_pointer_write( &current, foo[ i & 1]);
+      mulle_objc_universe_add_infraclass_nofail( universe, foo[ i & 1]);
+      _mulle_atomic_pointer_write( &round_nr, (void *) i);
+
+      while( (uintptr_t) _mulle_atomic_pointer_read( &checked) != i)
+         mulle_thread_yield();
+   }
+
+   mulle_thread_join( thread);
+
+   printf( "%s\n", _mulle_atomic_pointer_read( &failures) ? "stale" : "pass");
+   return( 0);
+}
@@ -0,0 +1,170 @@
+//
+//  prefill.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// A number of classes are added to the universe, then the class cache is
+// presized and prefilled. The cache must be large enough to hold all
+// classes and every class must be found in it, without the lookup having
+// to fill or grow the cache. A removed class must not reappear after the
+// next prefill.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define N_CLASSES   40
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_class( struct _mulle_objc_universe *universe, char *name)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe,
+                                              mulle_objc_classid_from_string( name),
+                                              name,
+                                              0,
+                                              0,
+                                              NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   return( infra);
+}
+
+
+static struct _mulle_objc_cache   *
+   get_classcache( struct _mulle_objc_universe *universe)
+{
+   return( _mulle_objc_cachepivot_atomicget_cache( &universe->cachepivot));
+}
+
+
+static int   check_classcache( struct _mulle_objc_universe *universe,
+                               struct _mulle_objc_infraclass **classes,
+                               unsigned int n)
+{
+   struct _mulle_objc_cache        *cache;
+   struct _mulle_objc_infraclass   *infra;
+   mulle_objc_classid_t            classid;
+   unsigned int                    i;
+   int                             rval;
+
+   rval  = 0;
+   cache = get_classcache( universe);
+   if( cache->size < n)
+   {
+      printf( "cache too small: %lu < %u\n", (unsigned long) cache->size, n);
+      rval = -1;
+   }
+   if( (uintptr_t) _mulle_atomic_pointer_read( &cache->n) != n)
+   {
+      printf( "cache count: %lu != %u\n",
+              (unsigned long) (uintptr_t) _mulle_atomic_pointer_read( &cache->n), n);
+      rval = -1;
+   }
+
+   for( i = 0; i < n; i++)
+   {
+      classid = _mulle_objc_infraclass_get_classid( classes[ i]);
+      if( _mulle_objc_cache_lookup_pointer( cache, classid) != classes[ i])
+      {
+         printf( "%s not in cache\n", _mulle_objc_infraclass_get_name( classes[ i]));
+         rval = -1;
+      }
+
+      infra = _mulle_objc_universe_lookup_infraclass_nofast( universe, classid);
+      if( infra != classes[ i])
+      {
+         printf( "%s not found\n", _mulle_objc_infraclass_get_name( classes[ i]));
+         rval = -1;
+      }
+   }
+
+   // lookups must have hit, a miss would have filled or grown the cache
+   if( get_classcache( universe) != cache)
+   {
+      printf( "cache changed by lookup\n");
+      rval = -1;
+   }
+   return( rval);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *classes[ N_CLASSES];
+   struct _mulle_objc_infraclass   *removed;
+   struct _mulle_objc_cache        *cache;
+   char                            name[ 32];
+   unsigned int                    i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   for( i = 0; i < N_CLASSES; i++)
+   {
+      sprintf( name, "Prefill%u", i);
+      classes[ i] = new_class( universe, name);
+      mulle_objc_universe_add_infraclass_nofail( universe, classes[ i]);
+   }
+
+   if( mulle_objc_universe_presize_classcache( universe))
+      return( 1);
+   printf( "presize: %s\n", check_classcache( universe, classes, N_CLASSES) ? "fail" : "pass");
+
+   // large enough already, presize keeps the cache
+   cache = get_classcache( universe);
+   if( mulle_objc_universe_presize_classcache( universe))
+      return( 1);
+   printf( "presize again: %s\n", get_classcache( universe) == cache ? "kept" : "replaced");
+
+   if( mulle_objc_universe_prefill_classcache( universe))
+      return( 1);
+   printf( "prefill: %s\n", check_classcache( universe, classes, N_CLASSES) ? "fail" : "pass");
+
+   removed = classes[ N_CLASSES - 1];
+   if( mulle_objc_universe_remove_infraclass( universe, removed))
+      return( 1);
+   if( mulle_objc_universe_prefill_classcache( universe))
+      return( 1);
+   printf( "prefill after remove: %s\n",
+           check_classcache( universe, classes, N_CLASSES - 1) ? "fail" : "pass");
+   printf( "removed: %s\n",
+           _mulle_objc_cache_lookup_pointer( get_classcache( universe),
+                                             _mulle_objc_infraclass_get_classid( removed))
+              ? "cached" : "gone");
+
+   return( 0);
+}
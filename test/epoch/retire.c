@@ -0,0 +1,104 @@
+//
+//  retire.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Retired blocks must only be freed after the epoch advanced past them,
+// which needs every active thread to have observed the new epoch. A
+// quiescent thread does not hold back the epoch, a checkin makes it active
+// again. Everything left in limbo is freed by done.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <errno.h>
+#include <stdio.h>
+
+
+static unsigned int   n_freed;
+static int            blocks[ 8];
+
+
+static void   count_free( void *p)
+{
+   ++n_freed;
+}
+
+
+static void   print( char *label, struct _mulle_objc_epochgc *gc)
+{
+   printf( "%s: epoch=%lu freed=%u pending=%lu/%lu\n",
+           label,
+           (unsigned long) (uintptr_t) _mulle_atomic_pointer_read( &gc->epoch),
+           n_freed,
+           (unsigned long) _mulle_objc_epochgc_get_pending_count( gc),
+           (unsigned long) _mulle_objc_epochgc_get_pending_bytes( gc));
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_epochgc   gc;
+   int                          rval;
+
+   if( _mulle_objc_epochgc_init( &gc))
+   {
+      perror( "_mulle_objc_epochgc_init");
+      return( 1);
+   }
+
+   // not registered yet
+   rval = _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 0], 16);
+   printf( "unregistered retire: %d %s\n", rval, errno == EINVAL ? "EINVAL" : "?");
+
+   _mulle_objc_epochgc_register_current_thread( &gc);
+
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 0], 16);
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 1], 16);
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 2], 0);
+   print( "retire", &gc);
+
+   // each checkin advances once, the blocks are freed two epochs later
+   _mulle_objc_epochgc_checkin_current_thread( &gc);
+   print( "checkin 1", &gc);
+   _mulle_objc_epochgc_checkin_current_thread( &gc);
+   print( "checkin 2", &gc);
+   _mulle_objc_epochgc_checkin_current_thread( &gc);
+   print( "checkin 3", &gc);
+
+   // an active thread, that doesn't check in, holds back the epoch
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 3], 32);
+   _mulle_objc_epochgc_reclaim( &gc);
+   print( "active reclaim", &gc);
+
+   // a quiescent one does not
+   _mulle_objc_epochgc_enter_quiescence( &gc);
+   printf( "quiescent: %d\n", _mulle_objc_epochgc_is_current_thread_quiescent( &gc));
+   _mulle_objc_epochgc_reclaim( &gc);
+   print( "quiescent reclaim", &gc);
+
+   // checkin is a safe point and leaves quiescence
+   _mulle_objc_epochgc_checkin_current_thread( &gc);
+   printf( "quiescent after checkin: %d\n", _mulle_objc_epochgc_is_current_thread_quiescent( &gc));
+
+   _mulle_objc_epochgc_enter_quiescence( &gc);
+   _mulle_objc_epochgc_leave_quiescence( &gc);
+   printf( "quiescent after leave: %d\n", _mulle_objc_epochgc_is_current_thread_quiescent( &gc));
+
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 4], 64);
+   _mulle_objc_epochgc_unregister_current_thread( &gc);
+   print( "unregister", &gc);
+   printf( "quiescent after unregister: %d\n", _mulle_objc_epochgc_is_current_thread_quiescent( &gc));
+
+   _mulle_objc_epochgc_done( &gc);
+   print( "done", &gc);
+
+   return( 0);
+}
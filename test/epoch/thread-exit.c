@@ -0,0 +1,120 @@
+//
+//  thread-exit.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// A registered thread, that doesn't check in, holds back reclamation. When
+// it exits without unregistering, its record must be released by the
+// thread local destructor, so that reclamation continues, and the record
+// must be reused by the next thread.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+static struct _mulle_objc_epochgc   gc;
+static mulle_atomic_pointer_t       state;  // 1: registered, 2: may exit
+static unsigned int                 n_freed;
+static int                          blocks[ 4];
+
+
+static void   count_free( void *p)
+{
+   ++n_freed;
+}
+
+
+static void   wait_for_state( uintptr_t value)
+{
+   while( (uintptr_t) _mulle_atomic_pointer_read( &state) != value)
+      mulle_thread_yield();
+}
+
+
+static mulle_thread_rval_t   holder( void *arg)
+{
+   _mulle_objc_epochgc_register_current_thread( &gc);
+   _mulle_atomic_pointer_write( &state, (void *) 1);
+
+   wait_for_state( 2);
+   // exits without unregistering
+   return( 0);
+}
+
+
+static unsigned int   count_records( void)
+{
+   struct _mulle_objc_epochrecord   *record;
+   unsigned int                     n;
+
+   n      = 0;
+   record = _mulle_atomic_pointer_read( &gc.records);
+   for( ; record; record = record->next)
+      ++n;
+   return( n);
+}
+
+
+static void   checkin( unsigned int n)
+{
+   while( n--)
+      _mulle_objc_epochgc_checkin_current_thread( &gc);
+}
+
+
+static int   run_holder( void)
+{
+   mulle_thread_t   thread;
+
+   _mulle_atomic_pointer_write( &state, (void *) 0);
+   if( mulle_thread_create( holder, NULL, &thread))
+   {
+      perror( "mulle_thread_create");
+      return( -1);
+   }
+   wait_for_state( 1);
+
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 0], 8);
+   _mulle_objc_epochgc_retire( &gc, count_free, &blocks[ 1], 8);
+   checkin( 4);
+   printf( "held back: freed=%u\n", n_freed);
+
+   _mulle_atomic_pointer_write( &state, (void *) 2);
+   mulle_thread_join( thread);
+
+   checkin( 4);
+   printf( "after exit: freed=%u records=%u\n", n_freed, count_records());
+   return( 0);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   if( _mulle_objc_epochgc_init( &gc))
+   {
+      perror( "_mulle_objc_epochgc_init");
+      return( 1);
+   }
+   _mulle_objc_epochgc_register_current_thread( &gc);
+
+   if( run_holder())
+      return( 1);
+
+   // the second thread must get the record of the first
+   n_freed = 0;
+   if( run_holder())
+      return( 1);
+
+   _mulle_objc_epochgc_unregister_current_thread( &gc);
+   _mulle_objc_epochgc_done( &gc);
+   return( 0);
+}
@@ -0,0 +1,65 @@
+//
+//  audit.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Feeds a hashed string list with a wrong entry into the universe and
+// checks, that the audit finds the mismatch and the collision.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+#include <mulle-objc-runtime/mulle-objc-uniqueidaudit.h>
+
+#include <stdio.h>
+
+
+static struct
+{
+   unsigned int                          n_loadentries;
+   struct _mulle_objc_loadhashedstring   loadentries[ 3];
+} hashnames =
+{
+   3,
+   {
+      { MULLE_OBJC_INIT_METHODID, "init" },
+      { MULLE_OBJC_INIT_METHODID, "tini" },     // wrong
+      { 0xb3a66256, "NSObject" }
+   }
+};
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   unsigned int                  problems;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   _mulle_objc_universe_add_loadhashedstringlist( universe,
+                                                  (struct _mulle_objc_loadhashedstringlist *) &hashnames);
+
+   problems = mulle_objc_universe_audit_uniqueids_to_fp( universe, stdout);
+   printf( "problems: %u\n", problems);
+
+   return( 0);
+}
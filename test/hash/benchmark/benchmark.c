@@ -0,0 +1,139 @@
+//
+//  benchmark.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Compares the bytewise _mulle_fnv1a_32 with the wordwise
+// _mulle_objc_fnv1a_32 on short strings (typical selectors and class names)
+// and on long strings (KVC key paths, generated names). The results must be
+// the same. Timings go to stderr, set LOOPS in the environment to change the
+// number of iterations.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+static char   *short_strings[] =
+{
+   "init",
+   "dealloc",
+   "count",
+   "hash",
+   "isEqual:",
+   "NSObject",
+   "NSString",
+   "objectAtIndex:",
+   "setObject:forKey:",
+   "valueForKey:",
+   "description",
+   "respondsToSelector:",
+   NULL
+};
+
+
+static char   *long_strings[] =
+{
+   "countByEnumeratingWithState:objects:count:",
+   "addObserver:selector:name:object:",
+   "rangeOfString:options:range:locale:",
+   "initWithBytesNoCopy:length:encoding:freeWhenDone:",
+   "selectedObjects.firstObject.employee.department.manager.name",
+   "MulleObjCPropertyListPrintingGeneratedClassWithAVeryLongName",
+   NULL
+};
+
+
+static double   seconds_since( clock_t start)
+{
+   return( (double) (clock() - start) / CLOCKS_PER_SEC);
+}
+
+
+static size_t   total_length( char **strings)
+{
+   size_t   bytes;
+
+   bytes = 0;
+   while( *strings)
+      bytes += strlen( *strings++);
+   return( bytes);
+}
+
+
+static int   compare( char **strings)
+{
+   size_t   len;
+
+   for( ; *strings; strings++)
+   {
+      len = strlen( *strings);
+      if( _mulle_fnv1a_32( *strings, len) != _mulle_objc_fnv1a_32( *strings, len))
+         return( 0);
+   }
+   return( 1);
+}
+
+
+static void   run( char *title, char **strings, long loops)
+{
+   clock_t    start;
+   double     bytewise;
+   double     wordwise;
+   double     mb;
+   long       i;
+   char       **p;
+   uint32_t   sum;
+
+   mb  = (double) total_length( strings) * loops / (1024 * 1024);
+   sum = 0;
+
+   start = clock();
+   for( i = 0; i < loops; i++)
+      for( p = strings; *p; p++)
+         sum += _mulle_fnv1a_32( *p, strlen( *p));
+   bytewise = seconds_since( start);
+
+   start = clock();
+   for( i = 0; i < loops; i++)
+      for( p = strings; *p; p++)
+         sum -= _mulle_objc_fnv1a_32( *p, strlen( *p));
+   wordwise = seconds_since( start);
+
+   fprintf( stderr, "%-6s bytewise %8.3f MB/s, wordwise %8.3f MB/s\n",
+                    title,
+                    bytewise ? mb / bytewise : 0.0,
+                    wordwise ? mb / wordwise : 0.0);
+
+   printf( "%s: %s\n", title, ! sum && compare( strings) ? "ok" : "failed");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   long   loops;
+   char   *s;
+
+   s     = getenv( "LOOPS");
+   loops = s ? atol( s) : 1000000;
+
+   run( "short", short_strings, loops);
+   run( "long", long_strings, loops);
+
+   printf( "init: %s\n",
+           mulle_objc_uniqueid_from_string( "init") == MULLE_OBJC_INIT_METHODID
+              ? "ok"
+              : "failed");
+   return( 0);
+}
@@ -0,0 +1,171 @@
+//
+//  index.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// The ivar search uses an index over the class and its superclasses. When
+// an ivarlist is added after the index has been built, the next search must
+// rebuild the index and find the new ivar. A thread that isn't registered
+// with the universe gc must not rebuild (and abafree) the index, but still
+// find the ivar by searching the ivarlists.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+#define ___Bar_classid   MULLE_OBJC_CLASSID( 0xbbc7dbad)
+
+
+struct _gnu_mulle_objc_ivarlist
+{
+   unsigned int              n_ivars;  // must be #0 and same as struct _mulle_objc_methodlist
+
+   struct _mulle_objc_ivar   ivars[ 1];
+};
+
+
+static struct _gnu_mulle_objc_ivarlist   a_ivarlist = { 1, { { { 0, "a", "i" }, 0 } } };
+static struct _gnu_mulle_objc_ivarlist   b_ivarlist = { 1, { { { 0, "b", "i" }, 4 } } };
+static struct _gnu_mulle_objc_ivarlist   c_ivarlist = { 1, { { { 0, "c", "i" }, 8 } } };
+static struct _gnu_mulle_objc_ivarlist   d_ivarlist = { 1, { { { 0, "d", "i" }, 12 } } };
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_class( struct _mulle_objc_universe *universe,
+              mulle_objc_classid_t classid,
+              char *name,
+              struct _mulle_objc_infraclass *superclass,
+              struct _gnu_mulle_objc_ivarlist *ivarlist)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, classid, name, 16, 0, superclass);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, (struct _mulle_objc_ivarlist *) ivarlist);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+static void   search( char *label, struct _mulle_objc_infraclass *infra, char *name)
+{
+   struct _mulle_objc_ivar   *ivar;
+
+   ivar = mulle_objc_infraclass_search_ivar( infra, mulle_objc_ivarid_from_string( name));
+   printf( "%s: %s %s\n", label, name, ivar ? ivar->descriptor.name : "none");
+}
+
+
+static char   *index_state( struct _mulle_objc_infraclass *infra, void *old)
+{
+   struct _mulle_objc_infraclassindex   *index;
+   struct _mulle_objc_universe          *universe;
+
+   universe = _mulle_objc_infraclass_get_universe( infra);
+   index    = _mulle_atomic_pointer_read( &infra->ivarindex);
+   if( ! index)
+      return( "missing");
+   if( index == old)
+      return( "kept");
+   if( index->generation != (uintptr_t) _mulle_atomic_pointer_read( &universe->indexgeneration))
+      return( "stale");
+   return( old ? "rebuilt" : "built");
+}
+
+
+static mulle_thread_rval_t   unregistered( void *arg)
+{
+   struct _mulle_objc_infraclass   *bar = arg;
+   void                            *old;
+
+   printf( "thread registered: %s\n",
+           _mulle_objc_thread_isregistered_universe_gc( _mulle_objc_infraclass_get_universe( bar))
+              ? "yes" : "no");
+
+   old = _mulle_atomic_pointer_read( &bar->ivarindex);
+   search( "unregistered", bar, "d");
+   printf( "unregistered index: %s\n", index_state( bar, old));
+   return( 0);
+}
+
+
+static void   init_ivarid( struct _gnu_mulle_objc_ivarlist *list)
+{
+   list->ivars[ 0].descriptor.ivarid = mulle_objc_ivarid_from_string( list->ivars[ 0].descriptor.name);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   struct _mulle_objc_infraclass   *bar;
+   mulle_thread_t                  thread;
+   void                            *old;
+
+   init_ivarid( &a_ivarlist);
+   init_ivarid( &b_ivarlist);
+   init_ivarid( &c_ivarlist);
+   init_ivarid( &d_ivarlist);
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   foo = new_class( universe, ___Foo_classid, "Foo", NULL, &a_ivarlist);
+   bar = new_class( universe, ___Bar_classid, "Bar", foo, &b_ivarlist);
+
+   search( "first", bar, "a");
+   search( "first", bar, "b");
+   search( "first", bar, "c");
+   printf( "first index: %s\n", index_state( bar, NULL));
+
+   // the superclass gets a new ivarlist after the index was built
+   old = _mulle_atomic_pointer_read( &bar->ivarindex);
+   mulle_objc_infraclass_add_ivarlist_nofail( foo, (struct _mulle_objc_ivarlist *) &c_ivarlist);
+   search( "superclass added", bar, "c");
+   search( "superclass added", bar, "a");
+   printf( "superclass added index: %s\n", index_state( bar, old));
+
+   // unregistered threads search the lists and leave the index alone
+   mulle_objc_infraclass_add_ivarlist_nofail( bar, (struct _mulle_objc_ivarlist *) &d_ivarlist);
+   if( mulle_thread_create( unregistered, bar, &thread))
+      return( 1);
+   mulle_thread_join( thread);
+
+   old = _mulle_atomic_pointer_read( &bar->ivarindex);
+   search( "registered", bar, "d");
+   printf( "registered index: %s\n", index_state( bar, old));
+
+   return( 0);
+}
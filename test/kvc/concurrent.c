@@ -0,0 +1,191 @@
+//
+//  concurrent.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Threads set and look up kvcinfos of the same class, while another thread
+// keeps invalidating the kvc cache and a third one keeps adding new keys,
+// so that the cache is swapped for a larger one while the others add.
+// Every lookup must return an info for the key asked for. Infos added to a
+// cache that is being swapped out, must neither leak nor be freed twice
+// nor be used after they were freed (run with ASan).
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <string.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define N_THREADS        3
+#define N_ROUNDS         1000
+#define N_KEYS           24
+
+
+static char                       keys[ N_KEYS][ 8];
+static struct _mulle_objc_class   *cls;
+static mulle_atomic_pointer_t     done;
+static mulle_atomic_pointer_t     failures;
+static mulle_atomic_pointer_t     serial;
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_class   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( _mulle_objc_infraclass_as_class( infra));
+}
+
+
+static mulle_thread_rval_t   setter( void *arg)
+{
+   struct _mulle_objc_universe   *universe = arg;
+   struct _mulle_objc_kvcinfo    *info;
+   struct mulle_allocator        *allocator;
+   unsigned int                  round;
+   unsigned int                  i;
+
+   mulle_objc_thread_setup_threadinfo( universe);
+   _mulle_objc_thread_register_universe_gc( universe);
+
+   allocator = _mulle_objc_class_get_kvcinfo_allocator( cls);
+   for( round = 0; round < N_ROUNDS; round++)
+   {
+      for( i = 0; i < N_KEYS; i++)
+      {
+         info = _mulle_objc_class_lookup_kvcinfo( cls, keys[ i]);
+         if( info)
+         {
+            if( strcmp( info->cKey, keys[ i]))
+               _mulle_atomic_pointer_increment( &failures);
+            continue;
+         }
+
+         info = _mulle_objc_kvcinfo_new( keys[ i], allocator);
+         if( _mulle_objc_class_set_kvcinfo( cls, info))
+            _mulle_objc_kvcinfo_free( info, allocator);
+      }
+      _mulle_objc_thread_checkin_universe_gc( universe);
+   }
+
+   _mulle_objc_thread_remove_universe_gc( universe);
+   mulle_objc_thread_unset_threadinfo( universe);
+   return( 0);
+}
+
+
+static mulle_thread_rval_t   grower( void *arg)
+{
+   struct _mulle_objc_universe   *universe = arg;
+   struct _mulle_objc_kvcinfo    *info;
+   struct mulle_allocator        *allocator;
+   char                          key[ 32];
+
+   mulle_objc_thread_setup_threadinfo( universe);
+   _mulle_objc_thread_register_universe_gc( universe);
+
+   allocator = _mulle_objc_class_get_kvcinfo_allocator( cls);
+   while( ! _mulle_atomic_pointer_read( &done))
+   {
+      sprintf( key, "grow%lu",
+               (unsigned long) (uintptr_t) _mulle_atomic_pointer_increment( &serial));
+      info = _mulle_objc_kvcinfo_new( key, allocator);
+      if( _mulle_objc_class_set_kvcinfo( cls, info))
+         _mulle_objc_kvcinfo_free( info, allocator);
+      _mulle_objc_thread_checkin_universe_gc( universe);
+   }
+
+   _mulle_objc_thread_remove_universe_gc( universe);
+   mulle_objc_thread_unset_threadinfo( universe);
+   return( 0);
+}
+
+
+static mulle_thread_rval_t   invalidator( void *arg)
+{
+   struct _mulle_objc_universe   *universe = arg;
+
+   mulle_objc_thread_setup_threadinfo( universe);
+   _mulle_objc_thread_register_universe_gc( universe);
+
+   while( ! _mulle_atomic_pointer_read( &done))
+   {
+      _mulle_objc_class_invalidate_kvccache( cls);
+      _mulle_objc_thread_checkin_universe_gc( universe);
+   }
+
+   _mulle_objc_thread_remove_universe_gc( universe);
+   mulle_objc_thread_unset_threadinfo( universe);
+   return( 0);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   mulle_thread_t                threads[ N_THREADS];
+   mulle_thread_t                thread;
+   mulle_thread_t                grow_thread;
+   unsigned int                  i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   cls      = new_foo( universe);
+
+   for( i = 0; i < N_KEYS; i++)
+      sprintf( keys[ i], "key%u", i);
+
+   if( mulle_thread_create( invalidator, universe, &thread))
+      return( 1);
+   if( mulle_thread_create( grower, universe, &grow_thread))
+      return( 1);
+   for( i = 0; i < N_THREADS; i++)
+      if( mulle_thread_create( setter, universe, &threads[ i]))
+         return( 1);
+
+   for( i = 0; i < N_THREADS; i++)
+      mulle_thread_join( threads[ i]);
+   _mulle_atomic_pointer_write( &done, (void *) 1);
+   mulle_thread_join( thread);
+   mulle_thread_join( grow_thread);
+
+   _mulle_objc_class_invalidate_kvccache( cls);
+
+   printf( "%s\n", _mulle_atomic_pointer_read( &failures) ? "fail" : "pass");
+   return( 0);
+}
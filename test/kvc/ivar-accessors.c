@@ -0,0 +1,202 @@
+//
+//  ivar-accessors.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// The type specialized ivar accessors of a kvcinfo. The accessors are set
+// up, when the info is put into the kvc cache of a class, after offset and
+// valueTypes have been filled in. Each one is checked with a take followed
+// by a get. An info without an ivar must not get accessors, as the default
+// valueType would otherwise write into the first ivar.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+
+struct ivars
+{
+   char                    c;
+   short                   s;
+   int                     i;
+   long                    l;
+   long long               q;
+   float                   f;
+   double                  d;
+   long double             D;
+   mulle_objc_methodid_t   sel;
+   char                    *str;
+   void                    *obj;
+   struct { int a, b; }    st;
+};
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_class   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( _mulle_objc_infraclass_as_class( infra));
+}
+
+
+static struct _mulle_objc_class   *cls;
+
+
+//
+// put an info for key into the cache, like a resolver would, and get it back
+//
+static struct _mulle_objc_kvcinfo   *cache_info( char *key,
+                                                 char type,
+                                                 ptrdiff_t offset)
+{
+   struct _mulle_objc_kvcinfo   *info;
+   struct mulle_allocator       *allocator;
+
+   allocator = _mulle_objc_class_get_kvcinfo_allocator( cls);
+   info      = _mulle_objc_kvcinfo_new( key, allocator);
+   memset( info->valueType, type, 4);
+   info->offset = offset;
+   if( _mulle_objc_class_set_kvcinfo( cls, info))
+   {
+      _mulle_objc_kvcinfo_free( info, allocator);
+      return( NULL);
+   }
+   return( _mulle_objc_class_lookup_kvcinfo( cls, key));
+}
+
+
+static void   check( char *key,
+                     char type,
+                     ptrdiff_t offset,
+                     void *value,
+                     size_t size)
+{
+   struct _mulle_objc_kvcinfo   *info;
+   struct ivars                 ivars;
+   char                         buf[ sizeof( long double)];
+
+   memset( &ivars, 0, sizeof( ivars));
+   memset( buf, 0, sizeof( buf));
+
+   info = cache_info( key, type, offset);
+   if( ! info)
+   {
+      printf( "%s: not cached\n", key);
+      return;
+   }
+   if( _mulle_objc_kvcinfo_take_ivarvalue( info, &ivars, value))
+   {
+      printf( "%s: no take\n", key);
+      return;
+   }
+   if( memcmp( &((char *) &ivars)[ offset], value, size))
+   {
+      printf( "%s: take failed\n", key);
+      return;
+   }
+   if( _mulle_objc_kvcinfo_get_ivarvalue( info, &ivars, buf))
+   {
+      printf( "%s: no get\n", key);
+      return;
+   }
+   printf( "%s: %s\n", key, memcmp( buf, value, size) ? "get failed" : "ok");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   struct _mulle_objc_kvcinfo    *info;
+   struct ivars                  ivars;
+   char                          c   = 'x';
+   short                         s   = -1848;
+   int                           i   = 1848;
+   long                          l   = -18481848L;
+   long long                     q   = 0x1848184818481848LL;
+   float                         f   = 18.48f;
+   double                        d   = -1848.1848;
+   long double                   D;
+   mulle_objc_methodid_t         sel = MULLE_OBJC_INIT_METHODID;
+   char                          *str = "VfL Bochum 1848";
+   void                          *obj = NULL;
+
+   // padding bytes of long double are compared too
+   memset( &D, 0, sizeof( D));
+   D = 1848.0L;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   cls      = new_foo( universe);
+
+   // a fresh info has no ivar, so no accessors for its default valueType
+   info = _mulle_objc_kvcinfo_new( "fresh", _mulle_objc_class_get_kvcinfo_allocator( cls));
+   printf( "fresh: %s\n", info->ivarget || info->ivartake ? "accessors" : "no accessors");
+   _mulle_objc_kvcinfo_free( info, _mulle_objc_class_get_kvcinfo_allocator( cls));
+
+   // neither has a method only info, that went through the cache
+   info = cache_info( "method", _C_ID, MULLE_OBJC_KVCINFO_NO_IVAR);
+   printf( "method: %s\n", _mulle_objc_kvcinfo_take_ivarvalue( info, &ivars, &obj) == -1
+                            ? "no accessors"
+                            : "accessors");
+
+   check( "c", _C_CHR, offsetof( struct ivars, c), &c, sizeof( c));
+   check( "s", _C_SHT, offsetof( struct ivars, s), &s, sizeof( s));
+   check( "i", _C_INT, offsetof( struct ivars, i), &i, sizeof( i));
+   check( "l", _C_LNG, offsetof( struct ivars, l), &l, sizeof( l));
+   check( "q", _C_LNG_LNG, offsetof( struct ivars, q), &q, sizeof( q));
+   check( "f", _C_FLT, offsetof( struct ivars, f), &f, sizeof( f));
+   check( "d", _C_DBL, offsetof( struct ivars, d), &d, sizeof( d));
+   check( "D", _C_LNG_DBL, offsetof( struct ivars, D), &D, sizeof( D));
+   check( "sel", _C_SEL, offsetof( struct ivars, sel), &sel, sizeof( sel));
+   check( "str", _C_CHARPTR, offsetof( struct ivars, str), &str, sizeof( str));
+   check( "assign", _C_ASSIGN_ID, offsetof( struct ivars, obj), &str, sizeof( str));
+   check( "retain", _C_RETAIN_ID, offsetof( struct ivars, obj), &obj, sizeof( obj));
+   check( "copy", _C_COPY_ID, offsetof( struct ivars, obj), &obj, sizeof( obj));
+
+   // no accessor for structs
+   info = cache_info( "st", _C_STRUCT_B, offsetof( struct ivars, st));
+   printf( "st: %s\n", _mulle_objc_kvcinfo_take_ivarvalue( info, &ivars, &i) == -1
+                        ? "ok"
+                        : "unexpected take");
+
+   return( 0);
+}
@@ -0,0 +1,391 @@
+//
+//  ivar-benchmark.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Compares KVC through the accessor methods with the type specialized ivar
+// accessors of the kvcinfo. Timings go to stderr, set LOOPS in the
+// environment to change the number of iterations.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+#define ___Foo_classid         MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define ___a___methodid        MULLE_OBJC_METHODID( 0x40c292ce)
+#define ___init__methodid      MULLE_OBJC_INIT_METHODID
+#define ___setA___methodid     MULLE_OBJC_METHODID( 0xffb5e54a)
+
+#define ___a___ivarid          MULLE_OBJC_IVARID( 0x40c292ce)
+
+
+struct _gnu_mulle_objc_methodlist
+{
+   unsigned int                n_methods; // must be #0 and same as struct _mulle_objc_ivarlist
+   void                        *owner;
+   struct _mulle_objc_method   methods[];
+};
+
+
+struct _gnu_mulle_objc_ivarlist
+{
+   unsigned int              n_ivars;  // must be #0 and same as struct _mulle_objc_methodlist
+
+   struct _mulle_objc_ivar   ivars[];
+};
+
+
+struct _gnu_mulle_objc_loadclasslist
+{
+   unsigned int                    n_loadclasses;
+   struct _mulle_objc_loadclass    *loadclasses[];
+};
+
+
+
+/* in this example, Foo inherits from Object and has a category
+
+
+   @interface Foo
+   {
+      int  a;
+   }
+   - (void) setA:(int) a;
+   - (int) a;
+   @end
+
+   @implementation Foo
+   - (void *) init
+   {
+      self->a = 1;
+      return( self);
+   }
+   - (void) setA:(int) a
+   {
+      self->a = a;
+   }
+   - (int) a
+   {
+      return( a);
+   }
+   @end
+
+
+   int   main( int argc, const char * argv[])
+   {
+      Foo  *obj;
+
+      obj = [[Foo alloc] init];
+
+      return 0;
+   }
+  */
+
+// @interface Foo : Object
+
+#define __Foo_iVARs  \
+
+struct Foo
+{
+   int   a;
+};
+
+// @end
+
+// @implementation Foo
+//
+//- (void *) init
+//{
+//   a = 1;
+//   b = 2;
+//
+//   return( self);
+//}
+//
+
+static void   *Foo_init( struct Foo *self, mulle_objc_methodid_t _cmd, void *_params)
+{
+   self->a = 1;
+
+   return( self);
+}
+
+
+// - (void) setA:(int) a b:(int) b
+// {
+//    self->a = a;
+//    self->b = b;
+// }
+
+//
+// figure out if we can get the compiler to alias a  with _params->_a with
+// "const"ing
+//
+static void   Foo_setA_b_( struct Foo *self, mulle_objc_methodid_t _cmd, void *_params)
+{
+   int   a = (int) (intptr_t) _params;
+
+   self->a = a;
+}
+
+
+static void   *Foo_a( struct Foo *self, mulle_objc_methodid_t _cmd, void *_params)
+{
+   return( (void *) (intptr_t) self->a);
+}
+
+// @end
+
+
+static struct _gnu_mulle_objc_ivarlist  Foo_ivarlist =
+{
+   1,
+   // must be sorted by ivarid !!!
+   {
+      {
+         {
+            ___a___ivarid,
+            "a",
+            "i"
+         },
+         offsetof( struct Foo, a)
+      }
+   }
+};
+
+
+static struct _gnu_mulle_objc_methodlist  Foo_instance_methodlist =
+{
+   3,
+   NULL,
+   {
+      {
+         // idee make this "197380f3\0setA:b:\0@:ii" as a uniquable string
+         // also saving an additional 2 pointers for method definition
+         // but what if the type differs ?
+         {
+            ___a___methodid,
+            "@:",
+            "a",
+            0
+         },
+         (void *) Foo_a
+      },
+      {
+         {
+            ___init__methodid,
+            "@:",
+            "init",
+            0
+         },
+         (void *) Foo_init
+      },
+      {
+         // idee make this "197380f3\0setA:b:\0@:ii" as a uniquable string
+         // also saving an additional 2 pointers for method definition
+         // but what if the type differs ?
+         {
+            ___setA___methodid,
+            "@:ii",
+            "setA:",
+            0
+         },
+         (void *) Foo_setA_b_
+      }
+   }
+};
+
+
+static struct _mulle_objc_loadclass  Foo_loadclass =
+{
+   ___Foo_classid,
+   "Foo",
+   0,
+
+   0,
+   NULL,
+   0,
+
+   -1,
+   sizeof( struct Foo),
+
+   (struct _mulle_objc_ivarlist *)  &Foo_ivarlist,
+   NULL,
+   (struct _mulle_objc_methodlist *) &Foo_instance_methodlist,
+   NULL,
+
+   NULL
+};
+
+
+
+struct _gnu_mulle_objc_loadclasslist  class_list =
+{
+   1,
+   {
+      &Foo_loadclass
+   }
+};
+
+
+
+
+#ifdef __MULLE_OBJC_NO_TPS__
+# define TPS_BIT   0x4
+#else
+# define TPS_BIT   0
+#endif
+
+#ifdef __MULLE_OBJC_NO_FCS__
+# define FCS_BIT   0x8
+#else
+# define FCS_BIT   0
+#endif
+
+
+
+static struct _mulle_objc_loadinfo  load_info =
+{
+   {
+      MULLE_OBJC_RUNTIME_LOAD_VERSION,
+      MULLE_OBJC_RUNTIME_VERSION,
+      0,
+      0,
+      TPS_BIT | FCS_BIT
+   },
+   NULL,
+   (struct _mulle_objc_loadclasslist *) &class_list,  // let runtime sort for us
+   NULL,
+   NULL,
+   NULL,
+};
+
+
+
+MULLE_C_CONSTRUCTOR( __load)
+static void  __load()
+{
+   static int  has_loaded;
+
+   fprintf( stderr, "--> __load\n");
+
+   // windows w/o mulle-clang
+   if( has_loaded)
+      return;
+   has_loaded = 1;
+
+   mulle_objc_loadinfo_enqueue_nofail( &load_info);
+}
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+   {
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+      universe->config.ignore_ivarhash_mismatch = 1;
+   }
+   return( universe);
+}
+
+
+
+static double   seconds_since( clock_t start)
+{
+   return( (double) (clock() - start) / CLOCKS_PER_SEC);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_infraclass    *infra;
+   struct _mulle_objc_class         *cls;
+   struct _mulle_objc_object        *obj;
+   struct _mulle_objc_kvcinfo       *info;
+   struct mulle_allocator           *allocator;
+   clock_t                          start;
+   char                             *s;
+   long                             loops;
+   long                             i;
+   long long                        sum;
+   int                              value;
+
+   // windows...
+#if ! defined( __clang__) && ! defined( __GNUC__)
+   __load();
+#endif
+
+   s     = getenv( "LOOPS");
+   loops = s ? atol( s) : 10000000;
+
+   infra = mulle_objc_global_lookup_infraclass_nofail( MULLE_OBJC_DEFAULTUNIVERSEID, ___Foo_classid);
+   obj   = mulle_objc_infraclass_alloc_instance( infra);
+   obj   = (void *) mulle_objc_object_call( obj, ___init__methodid, NULL);
+
+   cls       = _mulle_objc_infraclass_as_class( infra);
+   allocator = _mulle_objc_class_get_kvcinfo_allocator( cls);
+
+   info         = _mulle_objc_kvcinfo_new( "a", allocator);
+   info->offset = offsetof( struct Foo, a);
+   info->valueType[ MULLE_OBJC_KVCINFO_STOREDGET]  = _C_INT;
+   info->valueType[ MULLE_OBJC_KVCINFO_STOREDTAKE] = _C_INT;
+   _mulle_objc_kvcinfo_init_ivaraccessors( info);
+
+   // method based
+   start = clock();
+   for( i = 0; i < loops; i++)
+      mulle_objc_object_call( obj, ___setA___methodid, (void *) (intptr_t) (int) i);
+   fprintf( stderr, "method take: %.3fs\n", seconds_since( start));
+
+   sum   = 0;
+   start = clock();
+   for( i = 0; i < loops; i++)
+      sum += (int) (intptr_t) mulle_objc_object_call( obj, ___a___methodid, obj);
+   fprintf( stderr, "method get:  %.3fs\n", seconds_since( start));
+
+   printf( "method: %s\n", sum == (long long) (loops - 1) * loops ? "ok" : "failed");
+
+   // ivar based
+   start = clock();
+   for( i = 0; i < loops; i++)
+   {
+      value = (int) i;
+      _mulle_objc_kvcinfo_take_ivarvalue( info, obj, &value);
+   }
+   fprintf( stderr, "ivar take:   %.3fs\n", seconds_since( start));
+
+   sum   = 0;
+   start = clock();
+   for( i = 0; i < loops; i++)
+   {
+      _mulle_objc_kvcinfo_get_ivarvalue( info, obj, &value);
+      sum += value;
+   }
+   fprintf( stderr, "ivar get:    %.3fs\n", seconds_since( start));
+
+   printf( "ivar: %s\n", sum == (long long) (loops - 1) * loops ? "ok" : "failed");
+
+   _mulle_objc_kvcinfo_free( info, allocator);
+
+   // [obj release];
+   mulle_objc_instance_free( obj);
+
+   return 0;
+}
@@ -0,0 +1,244 @@
+//
+//  plan.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Build kvcplans for method keys, ivar keys and a mix of both with a
+// resolver, then get and take values with the plans. Ivar steps must have
+// the accessors for the type of their ivar, whether the info comes from
+// the resolver or from the kvc cache.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <errno.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+#define ___Foo_classid       MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define ___a___methodid      MULLE_OBJC_METHODID( 0x40c292ce)
+#define ___setA___methodid   MULLE_OBJC_METHODID( 0xffb5e54a)
+
+
+struct Foo
+{
+   void     *a;     // accessed with methods only
+   int      b;
+   double   c;
+};
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_class   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", sizeof( struct Foo), 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( _mulle_objc_infraclass_as_class( infra));
+}
+
+
+static void   *Foo_a( struct Foo *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   return( self->a);
+}
+
+
+static void   *Foo_setA_( struct Foo *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   self->a = _param;
+   return( NULL);
+}
+
+
+static struct _mulle_objc_kvcinfo   *resolve( struct _mulle_objc_class *cls,
+                                              char *key,
+                                              void *userinfo)
+{
+   struct _mulle_objc_kvcinfo   *info;
+
+   info = _mulle_objc_kvcinfo_new( key, _mulle_objc_class_get_kvcinfo_allocator( cls));
+
+   if( ! strcmp( key, "a"))
+   {
+      info->implementation[ MULLE_OBJC_KVCINFO_GET]  = (mulle_objc_implementation_t) Foo_a;
+      info->methodid[ MULLE_OBJC_KVCINFO_GET]        = ___a___methodid;
+      info->implementation[ MULLE_OBJC_KVCINFO_TAKE] = (mulle_objc_implementation_t) Foo_setA_;
+      info->methodid[ MULLE_OBJC_KVCINFO_TAKE]       = ___setA___methodid;
+      return( info);
+   }
+
+   // a resolver fills in offset and valueTypes after the info was created
+   if( ! strcmp( key, "b"))
+   {
+      info->offset = offsetof( struct Foo, b);
+      memset( info->valueType, _C_INT, 4);
+      return( info);
+   }
+
+   if( ! strcmp( key, "c"))
+   {
+      info->offset = offsetof( struct Foo, c);
+      memset( info->valueType, _C_DBL, 4);
+      return( info);
+   }
+
+   _mulle_objc_kvcinfo_free( info, _mulle_objc_class_get_kvcinfo_allocator( cls));
+   return( NULL);
+}
+
+
+static struct _mulle_objc_class   *cls;
+
+
+static void   test_methods( struct Foo *obj)
+{
+   struct _mulle_objc_kvcplan   *plan;
+   char                         *keys[] = { "a" };
+   void                         *values[ 1];
+
+   plan       = mulle_objc_kvcplan_new( cls, keys, 1, resolve, NULL);
+   values[ 0] = (void *) 0x1848;
+   if( _mulle_objc_kvcplan_take_values( plan, obj, MULLE_OBJC_KVCINFO_TAKE, values))
+      printf( "methods: no take\n");
+   values[ 0] = NULL;
+   if( _mulle_objc_kvcplan_get_values( plan, obj, MULLE_OBJC_KVCINFO_GET, values))
+      printf( "methods: no get\n");
+   printf( "methods: %s, ivar accessors: %s\n",
+           obj->a == (void *) 0x1848 && values[ 0] == (void *) 0x1848 ? "ok" : "FAIL",
+           _mulle_objc_kvcplan_has_all_ivaraccessors( plan, 0) ? "yes" : "no");
+   mulle_objc_kvcplan_free( plan);
+}
+
+
+static void   test_ivars( char *label, struct Foo *obj, int b, double c)
+{
+   struct _mulle_objc_kvcplan   *plan;
+   char                         *keys[] = { "b", "c" };
+   void                         *values[ 2];
+   int                          b_out;
+   double                       c_out;
+
+   plan       = mulle_objc_kvcplan_new( cls, keys, 2, resolve, NULL);
+   values[ 0] = &b;
+   values[ 1] = &c;
+   if( _mulle_objc_kvcplan_take_ivarvalues( plan, obj, values))
+   {
+      printf( "%s: no ivar take\n", label);
+      mulle_objc_kvcplan_free( plan);
+      return;
+   }
+
+   b_out      = 0;
+   c_out      = 0.0;
+   values[ 0] = &b_out;
+   values[ 1] = &c_out;
+   if( _mulle_objc_kvcplan_get_ivarvalues( plan, obj, values))
+      printf( "%s: no ivar get\n", label);
+   printf( "%s: %s, methods: %s\n",
+           label,
+           obj->b == b && obj->c == c && b_out == b && c_out == c ? "ok" : "FAIL",
+           _mulle_objc_kvcplan_has_all_implementations( plan, MULLE_OBJC_KVCINFO_GET) ? "yes" : "no");
+   mulle_objc_kvcplan_free( plan);
+}
+
+
+static void   test_mixed( struct Foo *obj)
+{
+   struct _mulle_objc_kvcplan   *plan;
+   struct _mulle_objc_kvcstep   *step;
+   char                         *keys[] = { "c", "a", "b" };
+   void                         *values[ 3];
+   int                          b;
+   double                       c;
+   unsigned int                 i;
+
+   plan = mulle_objc_kvcplan_new( cls, keys, 3, resolve, NULL);
+
+   // neither loop can do all keys, so it must do nothing
+   printf( "mixed loops: %s\n",
+           _mulle_objc_kvcplan_get_values( plan, obj, MULLE_OBJC_KVCINFO_GET, values) == -1 &&
+           _mulle_objc_kvcplan_get_ivarvalues( plan, obj, values) == -1 ? "refused" : "FAIL");
+
+   // per step, like the fallback of a caller
+   b = -18;
+   c = 48.5;
+   values[ 0] = &c;
+   values[ 1] = (void *) 0x4818;
+   values[ 2] = &b;
+   for( i = 0; i < _mulle_objc_kvcplan_get_count( plan); i++)
+   {
+      step = _mulle_objc_kvcplan_get_step( plan, i);
+      if( step->ivartake)
+         (*step->ivartake)( &((char *) obj)[ step->offset], values[ i]);
+      else
+         (*step->implementation[ MULLE_OBJC_KVCINFO_TAKE])( obj,
+                                                             step->methodid[ MULLE_OBJC_KVCINFO_TAKE],
+                                                             values[ i]);
+   }
+   printf( "mixed: %s\n",
+           obj->a == (void *) 0x4818 && obj->b == -18 && obj->c == 48.5 ? "ok" : "FAIL");
+
+   mulle_objc_kvcplan_free( plan);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   struct _mulle_objc_kvcplan    *plan;
+   struct Foo                    *obj;
+   char                          *unknown[] = { "b", "zz" };
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   cls      = new_foo( universe);
+   obj      = _mulle_objc_infraclass_alloc_instance( _mulle_objc_class_as_infraclass( cls));
+
+   test_methods( obj);
+   test_ivars( "ivars", obj, 1848, -18.48);
+
+   // now (partially) from the kvc cache
+   test_ivars( "cached ivars", obj, -1848, 18.48);
+   test_mixed( obj);
+
+   plan = mulle_objc_kvcplan_new( cls, unknown, 2, resolve, NULL);
+   printf( "unknown: %s\n", ! plan && errno == ENOENT ? "ENOENT" : "FAIL");
+
+   _mulle_objc_instance_free( obj);
+   return( 0);
+}
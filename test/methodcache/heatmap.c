@@ -0,0 +1,122 @@
+//
+//  heatmap.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// With MULLE_OBJC_COUNT_METHOD_CACHE the method cache counts its hits per
+// entry. Check the counts in the heat map CSV. The first call of a method
+// is a miss, that fills the cache.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define N_METHODS        3
+
+
+static char                    names[ N_METHODS][ 8];
+static mulle_objc_methodid_t   ids[ N_METHODS];
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+   {
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+      universe->debug.count.method_cache = 1;
+   }
+   return( universe);
+}
+
+
+static void   *method( void *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   return( self);
+}
+
+
+static struct _mulle_objc_methodlist   *new_methodlist( void)
+{
+   struct _mulle_objc_methodlist   *list;
+   unsigned int                    i;
+
+   list = calloc( 1, sizeof( struct _mulle_objc_methodlist) +
+                     sizeof( struct _mulle_objc_method) * (N_METHODS - 1));
+   list->n_methods = N_METHODS;
+   for( i = 0; i < N_METHODS; i++)
+   {
+      sprintf( names[ i], "m%u", i);
+      ids[ i] = mulle_objc_uniqueid_from_string( names[ i]);
+
+      list->methods[ i].descriptor.methodid  = ids[ i];
+      list->methods[ i].descriptor.name      = names[ i];
+      list->methods[ i].descriptor.signature = "@@:@";
+      list->methods[ i].value                = (mulle_objc_implementation_t) method;
+   }
+   mulle_objc_methodlist_sort( list);
+   return( list);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, new_methodlist());
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   void                            *obj;
+   unsigned int                    i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   foo      = new_foo( universe);
+   obj      = _mulle_objc_infraclass_alloc_instance( foo);
+
+   // m0: 1 miss + 2 hits, m1: 1 miss + 4 hits, m2 is never called
+   for( i = 0; i < 3; i++)
+      mulle_objc_object_call( obj, ids[ 0], obj);
+   for( i = 0; i < 5; i++)
+      mulle_objc_object_call( obj, ids[ 1], obj);
+
+   // classid;name;type;size;slot;home;distance;methodid;method;hits
+   mulle_objc_class_csvdump_cacheheatmap_to_fp( _mulle_objc_infraclass_as_class( foo), stdout);
+
+   _mulle_objc_instance_free( obj);
+   return( 0);
+}
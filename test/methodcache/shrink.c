@@ -0,0 +1,162 @@
+//
+//  shrink.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// A method cache that is hot (all methods in use) must survive
+// _mulle_objc_universe_shrink_methodcaches unchanged. A cache that is
+// sparse after an invalidation is shrunk, but keeps its entries.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define N_METHODS        64
+#define N_SPARSE         4
+
+
+static char                    names[ N_METHODS][ 8];
+static mulle_objc_methodid_t   ids[ N_METHODS];
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+   {
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+      universe->config.adaptive_cache = 1;
+   }
+   return( universe);
+}
+
+
+static void   *method( void *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   return( self);
+}
+
+
+static struct _mulle_objc_methodlist   *new_methodlist( void)
+{
+   struct _mulle_objc_methodlist   *list;
+   unsigned int                    i;
+
+   list = calloc( 1, sizeof( struct _mulle_objc_methodlist) +
+                     sizeof( struct _mulle_objc_method) * (N_METHODS - 1));
+   list->n_methods = N_METHODS;
+   for( i = 0; i < N_METHODS; i++)
+   {
+      sprintf( names[ i], "m%u", i);
+      ids[ i] = mulle_objc_uniqueid_from_string( names[ i]);
+
+      list->methods[ i].descriptor.methodid  = ids[ i];
+      list->methods[ i].descriptor.name      = names[ i];
+      list->methods[ i].descriptor.signature = "@:";
+      list->methods[ i].value                = (mulle_objc_implementation_t) method;
+   }
+   mulle_objc_methodlist_sort( list);
+   return( list);
+}
+
+
+static struct _mulle_objc_class   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, new_methodlist());
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+
+   _mulle_objc_class_setup( _mulle_objc_infraclass_as_class( infra));
+   return( _mulle_objc_infraclass_as_class( infra));
+}
+
+
+static unsigned int   count_cached( struct _mulle_objc_class *cls,
+                                    unsigned int n)
+{
+   unsigned int   i;
+   unsigned int   found;
+
+   found = 0;
+   for( i = 0; i < n; i++)
+      if( _mulle_objc_class_lookup_implementation_cacheonly( cls, ids[ i]))
+         ++found;
+   return( found);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   struct _mulle_objc_class      *cls;
+   struct _mulle_objc_cache      *cache;
+   mulle_objc_cache_uint_t       size;
+   unsigned int                  i;
+   unsigned int                  shrunk;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   cls      = new_foo( universe);
+
+   // hot: every method is in use (growing the cache drops entries, so
+   // repeat until all are cached)
+   do
+      for( i = 0; i < N_METHODS; i++)
+         _mulle_objc_class_lookup_implementation_noforward( cls, ids[ i]);
+   while( count_cached( cls, N_METHODS) != N_METHODS);
+
+   cache  = _mulle_objc_class_get_methodcache( cls);
+   size   = cache->size;
+   // call twice, a hot cache may have no misses since the last call
+   shrunk = _mulle_objc_universe_shrink_methodcaches( universe);
+   shrunk += _mulle_objc_universe_shrink_methodcaches( universe);
+   printf( "hot: shrunk=%u same=%s cached=%u/%u\n",
+           shrunk,
+           cache == _mulle_objc_class_get_methodcache( cls) ? "YES" : "NO",
+           count_cached( cls, N_METHODS),
+           N_METHODS);
+
+   // sparse: after an invalidate only a few methods are used again
+   _mulle_objc_class_invalidate_methodcacheentry( cls, MULLE_OBJC_NO_METHODID);
+   for( i = 0; i < N_SPARSE; i++)
+      _mulle_objc_class_lookup_implementation_noforward( cls, ids[ i]);
+
+   while( _mulle_objc_universe_shrink_methodcaches( universe))
+      ;
+
+   cache = _mulle_objc_class_get_methodcache( cls);
+   printf( "sparse: smaller=%s cached=%u/%u\n",
+           cache->size < size ? "YES" : "NO",
+           count_cached( cls, N_SPARSE),
+           N_SPARSE);
+
+   return( 0);
+}
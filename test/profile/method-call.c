@@ -0,0 +1,187 @@
+//
+//  method-call.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// With MULLE_OBJC_PROFILE_METHOD_CALL the method caches stay on. Calls on
+// cache hits and on misses must both be sampled and show up in the dump.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define ___Foo_classid      MULLE_OBJC_CLASSID( 0xc7e16770)
+#define ___outer_methodid   MULLE_OBJC_METHODID( 0x20bc574a)
+#define ___inner_methodid   MULLE_OBJC_METHODID( 0x8de6a27d)
+
+#define N_CALLS             100
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+   {
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+      universe->debug.profile.method_call = 1;  // sample every call
+   }
+   return( universe);
+}
+
+
+static void   *inner( void *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   return( self);
+}
+
+
+static void   *outer( void *self, mulle_objc_methodid_t _cmd, void *_param)
+{
+   unsigned int   i;
+
+   for( i = 0; i < N_CALLS; i++)
+      mulle_objc_object_call( self, ___inner_methodid, self);
+   return( self);
+}
+
+
+static struct _mulle_objc_methodlist   *new_methodlist( void)
+{
+   struct _mulle_objc_methodlist   *list;
+
+   list = calloc( 1, sizeof( struct _mulle_objc_methodlist) +
+                     sizeof( struct _mulle_objc_method));
+   list->n_methods = 2;
+
+   list->methods[ 0].descriptor.methodid  = ___outer_methodid;
+   list->methods[ 0].descriptor.name      = "outer";
+   list->methods[ 0].descriptor.signature = "@@:@";
+   list->methods[ 0].value                = (mulle_objc_implementation_t) outer;
+
+   list->methods[ 1].descriptor.methodid  = ___inner_methodid;
+   list->methods[ 1].descriptor.name      = "inner";
+   list->methods[ 1].descriptor.signature = "@@:@";
+   list->methods[ 1].value                = (mulle_objc_implementation_t) inner;
+
+   mulle_objc_methodlist_sort( list);
+   return( list);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, new_methodlist());
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+static uintptr_t   count_samples( struct _mulle_objc_universe *universe,
+                                  mulle_objc_methodid_t methodid)
+{
+   struct _mulle_objc_profilebuffer   *buffer;
+   struct _mulle_objc_profilesample   *p;
+   struct _mulle_objc_profilesample   *sentinel;
+   uintptr_t                          count;
+
+   count  = 0;
+   buffer = _mulle_objc_universe_get_profilebuffers( universe);
+   for( ; buffer; buffer = buffer->next)
+   {
+      p        = buffer->samples;
+      sentinel = &p[ MULLE_OBJC_PROFILEBUFFER_SIZE];
+      for( ; p < sentinel; p++)
+         if( p->count && p->methodid == methodid)
+            count += p->count;
+   }
+   return( count);
+}
+
+
+//
+// the callers may not be symbolizable and a miss and a hit may have
+// different return addresses, so sum up the counts per callee, which is
+// after the ';'
+//
+static unsigned long   sum_dump( struct _mulle_objc_universe *universe,
+                                 char *callee)
+{
+   FILE            *fp;
+   char            line[ 512];
+   char            *s;
+   size_t          len;
+   unsigned long   sum;
+
+   sum = 0;
+   len = strlen( callee);
+   fp  = tmpfile();
+   mulle_objc_universe_profiledump_to_fp( universe, fp);
+   rewind( fp);
+   while( fgets( line, sizeof( line), fp))
+   {
+      s = strrchr( line, ';');
+      if( s && ! strncmp( s + 1, callee, len) && s[ 1 + len] == ' ')
+         sum += strtoul( &s[ 1 + len], NULL, 10);
+   }
+   fclose( fp);
+   return( sum);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   struct _mulle_objc_class        *cls;
+   void                            *obj;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   foo      = new_foo( universe);
+   cls      = _mulle_objc_infraclass_as_class( foo);
+   obj      = _mulle_objc_infraclass_alloc_instance( foo);
+
+   mulle_objc_object_call( obj, ___outer_methodid, obj);
+
+   printf( "cached: %s\n",
+           _mulle_objc_class_lookup_implementation_cacheonly( cls, ___inner_methodid)
+              ? "YES" : "NO");
+   printf( "outer: %lu\n", (unsigned long) count_samples( universe, ___outer_methodid));
+   printf( "inner: %lu\n", (unsigned long) count_samples( universe, ___inner_methodid));
+   printf( "dump -[Foo outer]: %lu\n", sum_dump( universe, "-[Foo outer]"));
+   printf( "dump -[Foo inner]: %lu\n", sum_dump( universe, "-[Foo inner]"));
+
+   // don't write method-calls.folded at exit
+   _mulle_objc_universe_free_profilebuffers( universe);
+
+   _mulle_objc_instance_free( obj);
+   return( 0);
+}
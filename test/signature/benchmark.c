@@ -0,0 +1,248 @@
+//
+//  benchmark.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Parser throughput over the signatures of the descriptortable of the
+// universe. Without a Foundation the table only contains the descriptors
+// added here, which are taken from a Foundation. Timings go to stderr,
+// set LOOPS in the environment to change the number of iterations.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+static struct
+{
+   char   *name;
+   char   *signature;
+} corpus[] =
+{
+   { "init", "@16@0:8" },
+   { "dealloc", "v16@0:8" },
+   { "description", "@\"NSString\"16@0:8" },
+   { "hash", "Q16@0:8" },
+   { "isEqual:", "c24@0:8@16" },
+   { "count", "Q16@0:8" },
+   { "objectAtIndex:", "@24@0:8Q16" },
+   { "objectForKey:", "@24@0:8@16" },
+   { "setObject:forKey:", "v32@0:8@16@24" },
+   { "initWithBytes:length:", "@32@0:8^v16Q24" },
+   { "getBytes:range:", "v40@0:8^v16{_NSRange=QQ}24" },
+   { "rangeOfString:options:range:", "{_NSRange=QQ}48@0:8@\"NSString\"16Q24{_NSRange=QQ}32" },
+   { "substringWithRange:", "@\"NSString\"32@0:8{_NSRange=QQ}16" },
+   { "characterAtIndex:", "S24@0:8Q16" },
+   { "doubleValue", "d16@0:8" },
+   { "floatValue", "f16@0:8" },
+   { "initWithDouble:", "@24@0:8d16" },
+   { "compare:", "q24@0:8@16" },
+   { "sortedArrayUsingFunction:context:", "@32@0:8^?16^v24" },
+   { "enumerateObjectsUsingBlock:", "v24@0:8@?<v@?@Q^c>16" },
+   { "performSelector:withObject:afterDelay:", "v40@0:8:16@24d32" },
+   { "forwardInvocation:", "v24@0:8@\"NSInvocation\"16" },
+   { "methodSignatureForSelector:", "@\"NSMethodSignature\"24@0:8:16" },
+   { "initWithFrame:", "@48@0:8{CGRect={CGPoint=dd}{CGSize=dd}}16" },
+   { "transformStruct:", "{_transform=[6d]}64@0:8{_transform=[6d]}16" },
+   { "getValue:", "v24@0:8^v16" },
+   { "UTF8String", "*16@0:8" },
+   { "initWithCString:encoding:", "@32@0:8*16Q24" },
+   { "addObserver:selector:name:object:", "v48@0:8@16:24@\"NSString\"32@40" },
+   { "countByEnumeratingWithState:objects:count:", "Q40@0:8^{?=Q^@^Q[5Q]}16^@24Q32" },
+   { "unionWithBitfield:", "v24@0:8(?=ic)16" },
+   { "class", "#16@0:8" },
+   { "respondsToSelector:", "c24@0:8:16" },
+   { "retainCount", "Q16@0:8" },
+   { "longLongValue", "q16@0:8" },
+   { "initWithInt:", "@20@0:8i16" },
+   { "conformsToProtocol:", "c24@0:8@\"Protocol\"16" },
+   { "valueForKey:", "@24@0:8@\"NSString\"16" },
+   { "takeValue:forKey:", "v32@0:8@16@\"NSString\"24" },
+   { "dictionaryWithObjects:forKeys:count:", "@40@0:8^@16^@24Q32" },
+   { NULL, NULL }
+};
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static double   seconds_since( clock_t start)
+{
+   return( (double) (clock() - start) / CLOCKS_PER_SEC);
+}
+
+
+static void   report( char *title,
+                      double seconds,
+                      long loops,
+                      unsigned int n,
+                      size_t bytes)
+{
+   double   total;
+
+   total = (double) loops * n;
+   fprintf( stderr, "%-11s %8.3f MB/s %8.1f ns/signature\n",
+                    title,
+                    seconds ? (double) loops * bytes / (seconds * 1024 * 1024) : 0.0,
+                    total ? seconds * 1e9 / total : 0.0);
+}
+
+
+static void   add_corpus_descriptors( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_descriptor   *desc;
+   unsigned int                    i;
+
+   for( i = 0; corpus[ i].name; i++)
+   {
+      desc            = mulle_objc_universe_calloc( universe, 1, sizeof( *desc));
+      desc->methodid  = mulle_objc_methodid_from_string( corpus[ i].name);
+      desc->name      = corpus[ i].name;
+      desc->signature = corpus[ i].signature;
+      mulle_objc_universe_register_descriptor_nofail( universe, desc);
+   }
+}
+
+
+static char   **collect_signatures( struct _mulle_objc_universe *universe,
+                                    unsigned int *p_n,
+                                    size_t *p_bytes)
+{
+   struct mulle_concurrent_hashmapenumerator   rover;
+   struct _mulle_objc_descriptor               *desc;
+   unsigned int                                n;
+   unsigned int                                i;
+   size_t                                      bytes;
+   char                                        **signatures;
+
+   n          = mulle_concurrent_hashmap_count( &universe->descriptortable);
+   signatures = mulle_allocator_calloc( &mulle_default_allocator, n + 1, sizeof( char *));
+   bytes      = 0;
+   i          = 0;
+
+   rover = mulle_concurrent_hashmap_enumerate( &universe->descriptortable);
+   while( i < n && _mulle_concurrent_hashmapenumerator_next( &rover, NULL, (void **) &desc))
+   {
+      signatures[ i++] = desc->signature;
+      bytes           += strlen( desc->signature);
+   }
+   mulle_concurrent_hashmapenumerator_done( &rover);
+
+   *p_n     = i;
+   *p_bytes = bytes;
+   return( signatures);
+}
+
+
+static unsigned int   parse_supply( char **signatures, unsigned int n)
+{
+   struct mulle_objc_typeinfo   info;
+   unsigned int                 i;
+   unsigned int                 count;
+   char                         *s;
+
+   count = 0;
+   for( i = 0; i < n; i++)
+   {
+      s = signatures[ i];
+      while( s && *s)
+      {
+         s = _mulle_objc_signature_supply_typeinfo( s, NULL, &info);
+         ++count;
+      }
+   }
+   return( count);
+}
+
+
+static unsigned int   parse_enumerate( char **signatures, unsigned int n)
+{
+   struct mulle_objc_signatureenumerator   rover;
+   struct mulle_objc_typeinfo              info;
+   unsigned int                            i;
+   unsigned int                            count;
+
+   count = 0;
+   for( i = 0; i < n; i++)
+   {
+      rover = mulle_objc_signature_enumerate( signatures[ i]);
+      while( _mulle_objc_signatureenumerator_next( &rover, &info))
+         ++count;
+      _mulle_objc_signatureenumerator_rval( &rover, &info);
+      ++count;
+      mulle_objc_signatureenumerator_done( &rover);
+   }
+   return( count);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   clock_t                       start;
+   char                          **signatures;
+   char                          *s;
+   long                          loops;
+   long                          i;
+   unsigned int                  n;
+   unsigned int                  expect;
+   unsigned int                  count;
+   size_t                        bytes;
+   int                           ok;
+
+   s     = getenv( "LOOPS");
+   loops = s ? atol( s) : 100000;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   add_corpus_descriptors( universe);
+
+   signatures = collect_signatures( universe, &n, &bytes);
+   fprintf( stderr, "%u signatures, %lu bytes\n", n, (unsigned long) bytes);
+
+   expect = parse_supply( signatures, n);
+   printf( "corpus: %s\n", n && expect >= n * 3 ? "ok" : "failed");
+
+   ok    = 1;
+   start = clock();
+   for( i = 0; i < loops; i++)
+   {
+      count = parse_supply( signatures, n);
+      ok   &= count == expect;
+   }
+   report( "supply", seconds_since( start), loops, n, bytes);
+   printf( "supply: %s\n", ok ? "ok" : "failed");
+
+   ok    = 1;
+   start = clock();
+   for( i = 0; i < loops; i++)
+   {
+      count = parse_enumerate( signatures, n);
+      ok   &= count == expect;
+   }
+   report( "enumerator", seconds_since( start), loops, n, bytes);
+   printf( "enumerator: %s\n", ok ? "ok" : "failed");
+
+   mulle_allocator_free( &mulle_default_allocator, signatures);
+
+   return( 0);
+}
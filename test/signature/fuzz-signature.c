@@ -0,0 +1,212 @@
+//
+//  fuzz-signature.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// libFuzzer harness for the signature parser. Build it with clang on Linux:
+//
+//    clang -g -O1 -fsanitize=fuzzer,address,undefined -DMULLE_OBJC_FUZZ \
+//          -I<include> fuzz-signature.c <libs> -o fuzz-signature
+//    ./fuzz-signature fuzz-corpus
+//
+// Without MULLE_OBJC_FUZZ this is a regular test, that replays the files
+// given as arguments or, without arguments, the seeds below. Crashes found
+// by the fuzzer should be added to fuzz-corpus and to the seeds.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+//
+// parse everything with the checking parser first, only complete
+// signatures are passed on to the functions that expect valid input
+//
+static int   fuzz_signature( char *signature)
+{
+   struct mulle_objc_signatureenumerator   rover;
+   struct mulle_objc_typeinfo              info;
+   struct _mulle_objc_signatureinfo        *sinfo;
+   unsigned int                            n;
+   unsigned int                            i;
+   char                                    *s;
+
+   n = 0;
+   s = signature;
+   while( s && *s)
+   {
+      s = _mulle_objc_signature_supply_typeinfo( s, NULL, &info);
+      if( ! s)
+         return( 0);
+      ++n;
+   }
+
+   // need at least rval, self and _cmd
+   if( n < 3)
+      return( 0);
+
+   if( mulle_objc_signature_count_typeinfos( signature) != n)
+      abort();
+
+   i     = 0;
+   rover = mulle_objc_signature_enumerate( signature);
+   while( _mulle_objc_signatureenumerator_next( &rover, &info))
+      ++i;
+   _mulle_objc_signatureenumerator_rval( &rover, &info);
+   mulle_objc_signatureenumerator_done( &rover);
+
+   if( i + 1 != n)
+      abort();
+
+   if( _mulle_objc_signature_compare_lenient( signature, signature))
+      abort();
+   if( _mulle_objc_signature_get_lenienthash( signature) != _mulle_objc_signature_get_lenienthash( signature))
+      abort();
+
+   mulle_objc_signature_get_metaabiparamtype( signature);
+   _mulle_objc_signature_sizeof_metabistruct( signature);
+
+   sinfo = _mulle_objc_signatureinfo_new( signature, &mulle_default_allocator);
+   if( sinfo)
+   {
+      if( _mulle_objc_signatureinfo_get_count( sinfo) != n)
+         abort();
+      _mulle_objc_signatureinfo_free( sinfo, &mulle_default_allocator);
+   }
+   return( 1);
+}
+
+
+int   LLVMFuzzerTestOneInput( const uint8_t *data, size_t size)
+{
+   char   *s;
+
+   s = malloc( size + 1);
+   if( ! s)
+      return( 0);
+   memcpy( s, data, size);
+   s[ size] = 0;
+
+   fuzz_signature( s);
+
+   free( s);
+   return( 0);
+}
+
+
+#ifndef MULLE_OBJC_FUZZ
+
+static char   *seeds[] =
+{
+   "v16@0:8",
+   "@24@0:8@16",
+   "{_NSRange=QQ}48@0:8@16Q24{_NSRange=QQ}32",
+   "v40@0:8^v16{_NSRange=QQ}24",
+   "@28@0:8i16@?<v@?>20",
+   "Q40@0:8^{?=Q^@^Q[5Q]}16^@24Q32",
+   "{_transform=[6d]}64@0:8{_transform=[6d]}16",
+   "v24@0:8(?=ic)16",
+   "@\"NSString\"16@0:8",
+   // broken input, must not crash
+   "",
+   "@",
+   "{",
+   "{?=",
+   "[",
+   "[5",
+   "[5i",
+   "[0i]",
+   "[i]",
+   "[70000c]",
+   "[65535[65535d]]",
+   "b",
+   "(?=i",
+   "^",
+   "@\"",
+   "@\"NSString",
+   "@?<v@?",
+   NULL
+};
+
+
+//
+// replay from a heap copy, so that the sanitizer catches reads past the
+// terminating zero
+//
+static int   replay_string( char *signature)
+{
+   size_t   len;
+   char     *s;
+   int      valid;
+
+   len = strlen( signature);
+   s   = malloc( len + 1);
+   memcpy( s, signature, len + 1);
+
+   valid = fuzz_signature( s);
+
+   free( s);
+   return( valid);
+}
+
+
+static int   replay_file( const char *filename)
+{
+   FILE     *fp;
+   uint8_t  buf[ 4096];
+   size_t   len;
+   int      valid;
+   char     *s;
+
+   fp = fopen( filename, "rb");
+   if( ! fp)
+   {
+      perror( filename);
+      return( -1);
+   }
+   len = fread( buf, 1, sizeof( buf), fp);
+   fclose( fp);
+
+   s = malloc( len + 1);
+   memcpy( s, buf, len);
+   s[ len] = 0;
+
+   valid = fuzz_signature( s);
+   printf( "%s: %s\n", filename, valid ? "valid" : "invalid");
+
+   free( s);
+   return( 0);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   char   **p;
+   int    i;
+
+   if( argc > 1)
+   {
+      for( i = 1; i < argc; i++)
+         if( replay_file( argv[ i]))
+            return( 1);
+      return( 0);
+   }
+
+   for( p = seeds; *p; p++)
+      printf( "\"%s\": %s\n", *p, replay_string( *p) ? "valid" : "invalid");
+
+   return( 0);
+}
+
+#endif
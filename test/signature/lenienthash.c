@@ -0,0 +1,111 @@
+//
+//  lenienthash.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Registers descriptors with the same name but different signatures and
+// checks, which ones are flagged as varying in each method type warning
+// mode. Only the LENIENT mode remembers the lenient hash of the first
+// signature in the signaturehashtable. The warnings go to stderr.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static char   *mode_names[] =
+{
+   "NONE",
+   "LENIENT",
+   "NORMAL",
+   "STRICT"
+};
+
+
+static void   test( struct _mulle_objc_universe *universe,
+                    int mode,
+                    char *name,
+                    char *first,
+                    char *second)
+{
+   struct _mulle_objc_descriptor   *a;
+   struct _mulle_objc_descriptor   *b;
+   mulle_objc_methodid_t           methodid;
+   void                            *hash;
+   uintptr_t                       expect;
+
+   universe->debug.warn.method_type = mode;
+
+   methodid = mulle_objc_uniqueid_from_string( name);
+
+   // the universe keeps pointers to the descriptors
+   a = mulle_allocator_calloc( NULL, 2, sizeof( struct _mulle_objc_descriptor));
+   b = &a[ 1];
+
+   a->methodid  = methodid;
+   a->name      = name;
+   a->signature = first;
+   b->methodid  = methodid;
+   b->name      = name;
+   b->signature = second;
+
+   mulle_objc_universe_register_descriptor_nofail( universe, a);
+   mulle_objc_universe_register_descriptor_nofail( universe, b);
+
+   hash   = _mulle_concurrent_hashmap_lookup( &universe->signaturehashtable, methodid);
+   expect = _mulle_objc_signature_get_lenienthash( first);
+
+   printf( "%s %s \"%s\" \"%s\": %s%s\n",
+           mode_names[ mode],
+           name,
+           first,
+           second,
+           _mulle_objc_universe_lookup_varyingsignaturedescriptor( universe, methodid)
+              ? "varying"
+              : "same",
+           ! hash ? "" : (uintptr_t) hash == expect ? " (hashed)" : " (wrong hash)");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   // offsets and return value don't matter
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_LENIENT, "a:", "@16@0:8i12", "@@:i");
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_LENIENT, "b:", "@16@0:8i12", "v16@0:8i12");
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_LENIENT, "c:", "@16@0:8i12", "@16@0:8d12");
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_LENIENT, "d:e:", "@20@0:8i12i16", "@16@0:8i12");
+
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_NORMAL, "f:", "@16@0:8i12", "v16@0:8i12");
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_NORMAL, "g:", "@16@0:8i12", "@16@0:8d12");
+
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_STRICT, "h:", "@16@0:8i12", "v16@0:8i12");
+
+   test( universe, MULLE_OBJC_WARN_METHOD_TYPE_NONE, "i:", "@16@0:8i12", "@16@0:8d12");
+
+   return( 0);
+}
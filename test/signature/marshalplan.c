@@ -0,0 +1,235 @@
+//
+//  marshalplan.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// The copy runs of a marshalplan are computed from the invocation_offsets
+// of the signature. Check them against the layout the C compiler gives the
+// equivalent metaABI _param struct: padding after a char in front of a
+// double, adjacent arguments merged into one run, a struct return value
+// overriding the parameter type and the void_pointer case.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+struct field
+{
+   size_t   offset;
+   size_t   size;
+};
+
+#define FIELD( type, member)  { offsetof( type, member), sizeof( ((type *) 0)->member) }
+
+
+//
+// pack "param" and compare with the fields copied one after the other, then
+// unpack into a cleared _param block and compare the fields with the
+// original
+//
+static void   check( struct _mulle_objc_universe *universe,
+                     char *signature,
+                     void *param,
+                     size_t param_size,
+                     struct field *fields,
+                     unsigned int n_fields)
+{
+   struct _mulle_objc_signatureinfo   *info;
+   struct _mulle_objc_marshalplan     *plan;
+   char                               expect[ 256];
+   char                               packed[ 256];
+   char                               unpacked[ 256];
+   size_t                             len;
+   unsigned int                       i;
+   int                                pack_ok;
+   int                                unpack_ok;
+
+   info = _mulle_objc_universe_register_signatureinfo( universe, signature);
+   plan = mulle_objc_marshalplan_new( info, NULL);
+   if( ! plan)
+   {
+      printf( "%s: no plan\n", signature);
+      return;
+   }
+
+   len = 0;
+   for( i = 0; i < n_fields; i++)
+   {
+      memcpy( &expect[ len], &((char *) param)[ fields[ i].offset], fields[ i].size);
+      len += fields[ i].size;
+   }
+
+   memset( packed, 0xAA, sizeof( packed));
+   _mulle_objc_marshalplan_pack( plan, param, packed);
+   pack_ok = _mulle_objc_marshalplan_get_packedsize( plan) == len &&
+             ! memcmp( packed, expect, len);
+
+   memset( unpacked, 0, sizeof( unpacked));
+   _mulle_objc_marshalplan_unpack( plan, packed, unpacked);
+   unpack_ok = param_size <= _mulle_objc_signatureinfo_get_metaabisize( info);
+   for( i = 0; i < n_fields; i++)
+      unpack_ok &= ! memcmp( &unpacked[ fields[ i].offset],
+                             &((char *) param)[ fields[ i].offset],
+                             fields[ i].size);
+
+   // packedsize is checked by pack, it differs between 32 and 64 bit
+   printf( "%s: runs=%u rval=%lu object=%s pack=%s unpack=%s\n",
+           signature,
+           _mulle_objc_marshalplan_get_runcount( plan),
+           (unsigned long) _mulle_objc_marshalplan_get_rvalsize( plan),
+           _mulle_objc_marshalplan_has_object( plan) ? "yes" : "no",
+           pack_ok ? "ok" : "FAIL",
+           unpack_ok ? "ok" : "FAIL");
+
+   mulle_objc_marshalplan_free( plan);
+}
+
+
+struct char_double
+{
+   char     c;
+   double   d;
+};
+
+struct int_int
+{
+   int   a;
+   int   b;
+};
+
+struct char_int_double
+{
+   char     c;
+   int      i;
+   double   d;
+};
+
+struct point
+{
+   double   x;
+   double   y;
+};
+
+struct char_point_object
+{
+   char           c;
+   struct point   p;
+   void           *obj;
+};
+
+union double_int
+{
+   double   r;
+   struct
+   {
+      int   i;
+   } a;
+};
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   struct char_double            cd;
+   struct int_int                ii;
+   struct char_int_double        cid;
+   struct char_point_object      cpo;
+   union double_int              di;
+   void                          *vp;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   // padding after the char, two runs
+   memset( &cd, 0x55, sizeof( cd));
+   cd.c = 'x';
+   cd.d = 1.5;
+   {
+      struct field   fields[] = { FIELD( struct char_double, c),
+                                  FIELD( struct char_double, d) };
+
+      check( universe, "v@:cd", &cd, sizeof( cd), fields, 2);
+   }
+
+   // adjacent, merged into one run
+   ii.a = 1848;
+   ii.b = -1;
+   {
+      struct field   fields[] = { FIELD( struct int_int, a),
+                                  FIELD( struct int_int, b) };
+
+      check( universe, "v@:ii", &ii, sizeof( ii), fields, 2);
+   }
+
+   // padding after the char, int and double merged
+   memset( &cid, 0x55, sizeof( cid));
+   cid.c = 'y';
+   cid.i = 0x12345678;
+   cid.d = -2.25;
+   {
+      struct field   fields[] = { FIELD( struct char_int_double, c),
+                                  FIELD( struct char_int_double, i),
+                                  FIELD( struct char_int_double, d) };
+
+      check( universe, "v@:cid", &cid, sizeof( cid), fields, 3);
+   }
+
+   // struct argument and an object
+   memset( &cpo, 0x55, sizeof( cpo));
+   cpo.c   = 'z';
+   cpo.p.x = 3.0;
+   cpo.p.y = 4.0;
+   cpo.obj = &cpo;
+   {
+      struct field   fields[] = { FIELD( struct char_point_object, c),
+                                  FIELD( struct char_point_object, p),
+                                  FIELD( struct char_point_object, obj) };
+
+      check( universe, "v@:c{point=dd}@", &cpo, sizeof( cpo), fields, 3);
+   }
+
+   // double return value makes it a struct, the argument is at offset 0
+   memset( &di, 0x55, sizeof( di));
+   di.a.i = 1955;
+   {
+      struct field   fields[] = { FIELD( union double_int, a.i) };
+
+      check( universe, "d@:i", &di, sizeof( di), fields, 1);
+   }
+
+   // void_pointer, the _param is the argument itself
+   vp = &vp;
+   {
+      struct field   fields[] = { { 0, sizeof( void *) } };
+
+      check( universe, "v@:@", &vp, sizeof( vp), fields, 1);
+   }
+
+   // nothing to copy
+   check( universe, "v@:", NULL, 0, NULL, 0);
+
+   return( 0);
+}
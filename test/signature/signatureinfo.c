@@ -0,0 +1,99 @@
+//
+//  signatureinfo.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Signatureinfos are shared per signature string. Two different signatures
+// with the same signatureid (a FNV-1a collision) must each get their own
+// signatureinfo, in debug and in release builds.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <string.h>
+
+
+// these two have the same FNV-1a 32 hash 0x02d25316
+#define COLLISION_1   "@@:l@*fI*qc"
+#define COLLISION_2   "c@:dlfqClSi"
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static void   print( char *label, struct _mulle_objc_signatureinfo *info)
+{
+   if( ! info)
+   {
+      printf( "%s: none\n", label);
+      return;
+   }
+   printf( "%s: \"%s\" n=%u rval=%c\n",
+           label,
+           _mulle_objc_signatureinfo_get_signature( info),
+           _mulle_objc_signatureinfo_get_count( info),
+           *_mulle_objc_signatureinfo_get_rvaltypeinfo( info)->type);
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe        *universe;
+   struct _mulle_objc_signatureinfo   *info;
+   struct _mulle_objc_signatureinfo   *other;
+   struct _mulle_objc_signatureinfo   *a;
+   struct _mulle_objc_signatureinfo   *b;
+   char                               buf[ 32];
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   print( "unregistered", _mulle_objc_universe_lookup_signatureinfo( universe, "v@:i"));
+
+   info = _mulle_objc_universe_register_signatureinfo( universe, "v@:i");
+   print( "registered", info);
+
+   // a copy of the string finds the same info
+   strcpy( buf, "v@:i");
+   other = _mulle_objc_universe_register_signatureinfo( universe, buf);
+   printf( "shared: %s\n", info == other ? "yes" : "no");
+   printf( "lookup: %s\n", _mulle_objc_universe_lookup_signatureinfo( universe, buf) == info ? "yes" : "no");
+
+   printf( "invalid: %s\n", _mulle_objc_universe_register_signatureinfo( universe, "") ? "info" : "none");
+
+   printf( "same id: %s\n",
+           _mulle_objc_signature_get_signatureid( COLLISION_1) ==
+           _mulle_objc_signature_get_signatureid( COLLISION_2) ? "yes" : "no");
+
+   a = _mulle_objc_universe_register_signatureinfo( universe, COLLISION_1);
+   print( "1", a);
+   print( "2 before", _mulle_objc_universe_lookup_signatureinfo( universe, COLLISION_2));
+   b = _mulle_objc_universe_register_signatureinfo( universe, COLLISION_2);
+   print( "2", b);
+
+   print( "lookup 1", _mulle_objc_universe_lookup_signatureinfo( universe, COLLISION_1));
+   print( "lookup 2", _mulle_objc_universe_lookup_signatureinfo( universe, COLLISION_2));
+   printf( "shared 1: %s\n",
+           _mulle_objc_universe_register_signatureinfo( universe, COLLISION_1) == a ? "yes" : "no");
+   printf( "shared 2: %s\n",
+           _mulle_objc_universe_register_signatureinfo( universe, COLLISION_2) == b ? "yes" : "no");
+
+   return( 0);
+}
@@ -0,0 +1,105 @@
+//
+//  branchfree-isa.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Built with MULLE_OBJC_CALL_BRANCHFREE_ISA, _mulle_objc_object_get_isa
+// must find the same isa as the branching _mulle_objc_object_get_isa_universe
+// for regular objects and for tagged pointers of each configured index.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+#define MULLE_OBJC_CALL_BRANCHFREE_ISA  1
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+#define ___Bar_classid   MULLE_OBJC_CLASSID( 0xbbc7dbad)
+#define ___Baz_classid   MULLE_OBJC_CLASSID( 0x3bc7122d)
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_class( struct _mulle_objc_universe *universe,
+              mulle_objc_classid_t classid,
+              char *name)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, classid, name, 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+static void   check( char *label,
+                     void *obj,
+                     struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_class   *isa;
+
+   isa = _mulle_objc_object_get_isa( obj);
+   printf( "%s: %s %s\n",
+           label,
+           _mulle_objc_class_get_name( isa),
+           isa == _mulle_objc_object_get_isa_universe( obj, universe) ? "ok" : "FAIL");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   struct _mulle_objc_infraclass   *bar;
+   struct _mulle_objc_infraclass   *baz;
+   void                            *obj;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   foo = new_class( universe, ___Foo_classid, "Foo");
+   bar = new_class( universe, ___Bar_classid, "Bar");
+   baz = new_class( universe, ___Baz_classid, "Baz");
+
+   _mulle_objc_universe_set_taggedpointerclass_at_index( universe, bar, 1);
+   _mulle_objc_universe_set_taggedpointerclass_at_index( universe, baz, 3);
+
+   obj = _mulle_objc_infraclass_alloc_instance( foo);
+   check( "object", obj, universe);
+   check( "tagged 1", mulle_objc_create_unsigned_taggedpointer( 1848, 1), universe);
+   check( "tagged 1 (0)", mulle_objc_create_unsigned_taggedpointer( 0, 1), universe);
+   check( "tagged 3", mulle_objc_create_unsigned_taggedpointer( 18, 3), universe);
+   _mulle_objc_instance_free( obj);
+
+   return( 0);
+}
@@ -0,0 +1,76 @@
+//
+//  double.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Doubles at the boundaries of the tagged pointer encoding must come back
+// bit identical. Values outside the range must not be encoded, so that
+// the caller falls back to a boxed object.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+
+static void   test( char *label, double d)
+{
+   void     *p;
+   double   back;
+
+   p = mulle_objc_create_double_taggedpointer( d, 1);
+   if( ! p)
+   {
+      printf( "%s: boxed\n", label);
+      return;
+   }
+
+   back = mulle_objc_taggedpointer_get_double_value( p);
+   printf( "%s: tagged %s\n",
+           label,
+           ! memcmp( &back, &d, sizeof( double)) ? "ok" : "FAIL");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   double   smallest;
+   double   largest;
+
+   smallest = ldexp( 1.0, -126);
+   largest  = nextafter( ldexp( 1.0, 129), 0.0);
+
+   test( "0.0", 0.0);
+   test( "-0.0", -0.0);
+   test( "1.0", 1.0);
+   test( "-1848.5", -1848.5);
+   test( "0.1", 0.1);
+
+   test( "2^-126", smallest);
+   test( "-2^-126", -smallest);
+   test( "2^128", ldexp( 1.0, 128));
+   test( "below 2^129", largest);
+   test( "-below 2^129", -largest);
+
+   test( "below 2^-126", nextafter( smallest, 0.0));
+   test( "2^-127", ldexp( 1.0, -127));
+   test( "2^129", ldexp( 1.0, 129));
+   test( "DBL_MIN", DBL_MIN);
+   test( "denormal", DBL_MIN / 2);
+   test( "DBL_MAX", DBL_MAX);
+   test( "inf", INFINITY);
+   test( "-inf", -INFINITY);
+   test( "nan", NAN);
+
+   return( 0);
+}
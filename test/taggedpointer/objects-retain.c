@@ -0,0 +1,175 @@
+//
+//  objects-retain.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// _mulle_objc_objects_retain, _release and _releaseandzero process blocks
+// of eight and then a tail. Check the retain counts for lengths around the
+// block size with nil, tagged pointers and real objects, some of them
+// appearing more than once. The element after the array must be left
+// alone.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+
+
+#define ___Foo_classid   MULLE_OBJC_CLASSID( 0xc7e16770)
+
+#define N_OBJECTS        4
+#define MAX_LENGTH       17
+
+//
+// R: real object, N: nil, T: tagged pointer
+//
+static char   pattern[ MAX_LENGTH + 1] = "RNTRTRNTRRTNRTRNR";
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static struct _mulle_objc_infraclass   *
+   new_foo( struct _mulle_objc_universe *universe)
+{
+   struct _mulle_objc_classpair   *pair;
+   struct _mulle_objc_infraclass  *infra;
+   struct _mulle_objc_metaclass   *meta;
+
+   pair  = mulle_objc_universe_new_classpair( universe, ___Foo_classid, "Foo", 0, 0, NULL);
+   infra = _mulle_objc_classpair_get_infraclass( pair);
+   meta  = _mulle_objc_classpair_get_metaclass( pair);
+
+   mulle_objc_infraclass_add_ivarlist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_propertylist_nofail( infra, NULL);
+   mulle_objc_infraclass_add_methodlist_nofail( infra, NULL);
+   mulle_objc_metaclass_add_methodlist_nofail( meta, NULL);
+   mulle_objc_classpair_add_protocollist_nofail( pair, NULL);
+   mulle_objc_classpair_add_protocolclassids_nofail( pair, NULL);
+   mulle_objc_universe_add_infraclass_nofail( universe, infra);
+   return( infra);
+}
+
+
+static void   *objects[ N_OBJECTS];
+static void   *guard;
+
+
+static size_t   fill( void **array, size_t n)
+{
+   size_t   i;
+   size_t   n_real;
+
+   n_real = 0;
+   for( i = 0; i < n; i++)
+      switch( pattern[ i])
+      {
+      case 'R' : array[ i] = objects[ n_real++ % N_OBJECTS]; break;
+      case 'T' : array[ i] = mulle_objc_create_unsigned_taggedpointer( i, 1); break;
+      default  : array[ i] = NULL;
+      }
+   array[ n] = guard;
+   return( n_real);
+}
+
+
+//
+// each object must have a retaincount of 1 + delta times the number of
+// its occurrences in the first n elements
+//
+static int   check_counts( size_t n_real, int delta)
+{
+   size_t     i;
+   intptr_t   expect;
+
+   for( i = 0; i < N_OBJECTS; i++)
+   {
+      expect = 1 + delta * (intptr_t) (n_real / N_OBJECTS + (i < n_real % N_OBJECTS));
+      if( _mulle_objc_object_get_retaincount( objects[ i]) != expect)
+         return( 0);
+   }
+   return( _mulle_objc_object_get_retaincount( guard) == 1);
+}
+
+
+static int   check_zeroed( void **array, size_t n)
+{
+   size_t   i;
+
+   for( i = 0; i < n; i++)
+      if( array[ i])
+         return( 0);
+   return( array[ n] == guard);
+}
+
+
+static void   test( size_t n)
+{
+   void     *array[ MAX_LENGTH + 1];
+   size_t   n_real;
+   int      retain_ok;
+   int      release_ok;
+   int      zero_ok;
+
+   n_real = fill( array, n);
+
+   _mulle_objc_objects_retain( array, n);
+   retain_ok = check_counts( n_real, 1);
+
+   _mulle_objc_objects_release( array, n);
+   release_ok = check_counts( n_real, 0);
+
+   _mulle_objc_objects_retain( array, n);
+   _mulle_objc_objects_releaseandzero( array, n);
+   zero_ok = check_counts( n_real, 0) && check_zeroed( array, n);
+
+   printf( "%2zu: retain %s, release %s, releaseandzero %s\n",
+           n,
+           retain_ok ? "ok" : "FAIL",
+           release_ok ? "ok" : "FAIL",
+           zero_ok ? "ok" : "FAIL");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe     *universe;
+   struct _mulle_objc_infraclass   *foo;
+   unsigned int                    i;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+   foo      = new_foo( universe);
+
+   for( i = 0; i < N_OBJECTS; i++)
+      objects[ i] = _mulle_objc_infraclass_alloc_instance( foo);
+   guard = _mulle_objc_infraclass_alloc_instance( foo);
+
+   test( 0);
+   test( 7);
+   test( 8);
+   test( 9);
+   test( 17);
+
+   for( i = 0; i < N_OBJECTS; i++)
+      _mulle_objc_instance_free( objects[ i]);
+   _mulle_objc_instance_free( guard);
+
+   return( 0);
+}
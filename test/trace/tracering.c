@@ -0,0 +1,167 @@
+//
+//  tracering.c
+//  mulle-objc-runtime
+//
+//  Created by Nat! on 18.10.20.
+//  Copyright (c) 2020 Mulle kybernetiK. All rights reserved.
+//
+// Write events into the trace rings of two threads, more than fit into a
+// ring, so that they are flushed while writing. Then decode the file. The
+// second thread keeps writing after the tracefile is closed, which must
+// not touch freed memory.
+//
+#ifndef __MULLE_OBJC__
+# define __MULLE_OBJC_NO_TPS__
+# define __MULLE_OBJC_FCS__
+#endif
+
+
+#include <mulle-objc-runtime/mulle-objc-runtime.h>
+
+#include <stdio.h>
+#include <string.h>
+
+
+#define TRACEFILE       "tracering.trace"
+
+#define N_MAIN_EVENTS   (MULLE_OBJC_TRACERING_SIZE + 1000)
+#define N_THREAD_EVENTS 10
+
+
+static mulle_atomic_pointer_t   state;  // 1: thread has written, 2: closed
+
+
+struct _mulle_objc_universe  *
+   __register_mulle_objc_universe( mulle_objc_universeid_t universeid,
+                                   char *universename)
+{
+   struct _mulle_objc_universe    *universe;
+
+   universe = __mulle_objc_global_get_universe( universeid, universename);
+   if( ! _mulle_objc_universe_is_initialized( universe))
+      _mulle_objc_universe_bang( universe, 0, NULL, NULL);
+   return( universe);
+}
+
+
+static void   wait_for_state( intptr_t value)
+{
+   while( (intptr_t) _mulle_atomic_pointer_read( &state) != value)
+      mulle_thread_yield();
+}
+
+
+static void   emit( struct _mulle_objc_universe *universe,
+                    uint32_t classid,
+                    unsigned int n)
+{
+   unsigned int   i;
+
+   for( i = 0; i < n; i++)
+      _mulle_objc_universe_trace_event( universe,
+                                        mulle_objc_traceevent_method_call,
+                                        classid,
+                                        i,
+                                        (void *) (uintptr_t) i);
+}
+
+
+static mulle_thread_rval_t   writer( void *arg)
+{
+   struct _mulle_objc_universe   *universe = arg;
+
+   mulle_objc_thread_setup_threadinfo( universe);
+
+   emit( universe, 2, N_THREAD_EVENTS);
+   _mulle_atomic_pointer_write( &state, (void *) 1);
+
+   wait_for_state( 2);
+   emit( universe, 3, N_THREAD_EVENTS);
+
+   mulle_objc_thread_unset_threadinfo( universe);
+   return( 0);
+}
+
+
+static void   decode( char *filename)
+{
+   FILE                                *fp;
+   struct mulle_objc_tracefileheader   header;
+   struct mulle_objc_traceevent        event;
+   unsigned int                        n[ 4];
+   unsigned int                        expect[ 4];
+   unsigned int                        ordered;
+
+   fp = fopen( filename, "rb");
+   if( ! fp)
+   {
+      perror( filename);
+      return;
+   }
+
+   if( fread( &header, sizeof( header), 1, fp) != 1)
+   {
+      printf( "header: missing\n");
+      fclose( fp);
+      return;
+   }
+   printf( "header: %s\n",
+           header.magic == MULLE_OBJC_TRACEFILE_MAGIC &&
+           header.version == MULLE_OBJC_TRACEFILE_VERSION &&
+           header.recordsize == sizeof( struct mulle_objc_traceevent) ? "ok" : "FAIL");
+
+   memset( n, 0, sizeof( n));
+   memset( expect, 0, sizeof( expect));
+   ordered = 1;
+   while( fread( &event, sizeof( event), 1, fp) == 1)
+   {
+      if( event.type != mulle_objc_traceevent_method_call || event.classid > 3)
+      {
+         ordered = 0;
+         continue;
+      }
+      // events of a thread come in order
+      if( event.methodid != expect[ event.classid] ||
+          event.pointer != event.methodid)
+         ordered = 0;
+      expect[ event.classid] = event.methodid + 1;
+      n[ event.classid]++;
+   }
+   fclose( fp);
+
+   printf( "main: %u\n", n[ 1]);
+   printf( "thread: %u\n", n[ 2]);
+   printf( "after close: %u\n", n[ 3]);
+   printf( "ordered: %s\n", ordered ? "YES" : "NO");
+}
+
+
+int   main( int argc, const char * argv[])
+{
+   struct _mulle_objc_universe   *universe;
+   mulle_thread_t                thread;
+
+   universe = mulle_objc_global_register_universe( MULLE_OBJC_DEFAULTUNIVERSEID, NULL);
+
+   if( _mulle_objc_universe_open_tracefile( universe, TRACEFILE))
+   {
+      perror( TRACEFILE);
+      return( 1);
+   }
+
+   if( mulle_thread_create( writer, universe, &thread))
+      return( 1);
+   wait_for_state( 1);
+
+   // the ring fills up, unless flushed every half ring
+   emit( universe, 1, N_MAIN_EVENTS);
+
+   _mulle_objc_universe_close_tracefile( universe);
+   _mulle_atomic_pointer_write( &state, (void *) 2);
+   mulle_thread_join( thread);
+
+   decode( TRACEFILE);
+   remove( TRACEFILE);
+
+   return( 0);
+}